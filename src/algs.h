@@ -17,13 +17,409 @@
  * B. Accumulator: accumulator must stricly be a numeric type
  * C. X, T: purely generic types
  * D. Function: some generic function
+ * E. Compare: strict weak ordering, operator< unless given
+ *
+ * Overloads taking algs::par as their first argument split the work across
+ * threads with OpenMP when compiled with -fopenmp, and otherwise run serially
+ * with identical results. As with the standard execution policies, an
+ * exception escaping a parallel overload terminates the program.
+ *
+ * Contiguous ranges of arithmetic types take SIMD fast paths when the target
+ * supports SSE2, AVX2 or AVX-512 (-march=native enables the widest available).
+ * Define ALGS_NO_SIMD before including this header to force the portable
+ * loops, and ALGS_NO_PREFETCH to drop the software prefetches of the search
+ * functions.
  */
 
 #ifndef ALGS_H
 #define ALGS_H
 
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <forward_list>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if !defined(ALGS_NO_SIMD) && defined(__SSE2__)
+#define ALGS_SIMD
+#include <immintrin.h>
+#endif
+
 namespace algs {
 
+/*!
+ * Tag type selecting the parallel overload of an algorithm
+ */
+struct parallel_policy {};
+
+/*!
+ * Tag object passed as the first argument of the parallel overloads
+ */
+const parallel_policy par = parallel_policy();
+
+namespace detail {
+
+/*!
+ * Ranges shorter than this are processed serially by the parallel overloads
+ */
+const std::ptrdiff_t parallel_cutoff = 1 << 15;
+
+/*!
+ * Number of threads a parallel region may use
+ *
+ * @returns the OpenMP thread limit, or 1 when built without OpenMP
+ */
+inline int thread_count() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+/*!
+ * Number of chunks a range of length n is split into for parallel processing
+ *
+ * @param n length of the range
+ *
+ * @returns the chunk count, 1 if the range is too short to be worth splitting
+ */
+inline std::ptrdiff_t chunk_count(std::ptrdiff_t n) {
+  std::ptrdiff_t t = thread_count();
+  if (n < 2 * parallel_cutoff || t < 2)
+    return 1;
+  return t < n / parallel_cutoff ? t : n / parallel_cutoff;
+}
+
+/*!
+ * Offset of the first element of chunk i when splitting n elements into k
+ * nearly equal chunks
+ */
+inline std::ptrdiff_t chunk_begin(std::ptrdiff_t n, std::ptrdiff_t k,
+                                  std::ptrdiff_t i) {
+  return n / k * i + (i < n % k ? i : n % k);
+}
+
+/*!
+ * Calls task(i) for every i in [0,n), spreading the calls over the threads
+ *
+ * @param n number of tasks
+ * @param task functor whose calls for distinct i must not interfere
+ */
+template <class Task> void parallel_for(std::ptrdiff_t n, const Task &task) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (std::ptrdiff_t i = 0; i < n; ++i)
+    task(i);
+}
+
+/*!
+ * Calls task(i) for every i in [0,n) like parallel_for, but hands the calls
+ * to the threads one at a time as they become free, for tasks whose costs
+ * differ too much to split them evenly up front
+ *
+ * @param n number of tasks
+ * @param task functor whose calls for distinct i must not interfere
+ */
+template <class Task>
+void parallel_for_dynamic(std::ptrdiff_t n, const Task &task) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+  for (std::ptrdiff_t i = 0; i < n; ++i)
+    task(i);
+}
+
+/*!
+ * Scratch storage for n elements of type T, shrunk until the allocation
+ * succeeds like std::get_temporary_buffer. Elements are constructed by the
+ * user, who records how many with set_constructed(), and are destroyed along
+ * with the buffer.
+ */
+template <class T> class temporary_buffer {
+public:
+  explicit temporary_buffer(std::ptrdiff_t n) : buf(0), len(0), built(0) {
+    while (n > 0 && !buf) {
+      buf = static_cast<T *>(::operator new(n * sizeof(T), std::nothrow));
+      len = buf ? n : 0;
+      n /= 2;
+    }
+  }
+
+  ~temporary_buffer() {
+    for (std::ptrdiff_t i = 0; i < built; ++i)
+      buf[i].~T();
+    ::operator delete(buf);
+  }
+
+  T *data() const { return buf; }
+
+  std::ptrdiff_t size() const { return len; }
+
+  /*! Copy constructs every element of the buffer from x */
+  void fill(const T &x) {
+    std::uninitialized_fill(buf, buf + len, x);
+    built = len;
+  }
+
+  /*! Records that the first n elements have been constructed in place */
+  void set_constructed(std::ptrdiff_t n) { built = n; }
+
+private:
+  temporary_buffer(const temporary_buffer &);
+  temporary_buffer &operator=(const temporary_buffer &);
+
+  T *buf;
+  std::ptrdiff_t len, built;
+};
+
+/*!
+ * Default comparator of the ordering algorithms, comparing with operator<
+ */
+struct less {
+  template <class A, class B> bool operator()(const A &a, const B &b) const {
+    return a < b;
+  }
+};
+
+/*!
+ * Compile time boolean used to select between overloads
+ */
+template <bool B> struct bool_type {
+  static const bool value = B;
+};
+
+typedef bool_type<true> true_type;
+typedef bool_type<false> false_type;
+
+template <class A, class B> struct is_same : false_type {};
+template <class A> struct is_same<A, A> : true_type {};
+
+template <class T> struct remove_const {
+  typedef T type;
+};
+template <class T> struct remove_const<const T> {
+  typedef T type;
+};
+
+/*!
+ * Identifies the built-in integer types, excluding bool
+ */
+template <class T> struct is_integral : false_type {};
+template <> struct is_integral<char> : true_type {};
+template <> struct is_integral<signed char> : true_type {};
+template <> struct is_integral<unsigned char> : true_type {};
+template <> struct is_integral<short> : true_type {};
+template <> struct is_integral<unsigned short> : true_type {};
+template <> struct is_integral<int> : true_type {};
+template <> struct is_integral<unsigned int> : true_type {};
+template <> struct is_integral<long> : true_type {};
+template <> struct is_integral<unsigned long> : true_type {};
+template <> struct is_integral<long long> : true_type {};
+template <> struct is_integral<unsigned long long> : true_type {};
+
+/*!
+ * Identifies iterators over contiguous storage and converts them to pointers:
+ * raw pointers, and the vector and string iterators of libstdc++
+ */
+template <class It> struct contiguous : false_type {};
+
+template <class T> struct contiguous<T *> : true_type {
+  typedef typename remove_const<T>::type value_type;
+  static T *ptr(T *it) { return it; }
+};
+
+#ifdef __GLIBCXX__
+template <class T, class Container>
+struct contiguous<__gnu_cxx::__normal_iterator<T *, Container> >
+    : true_type {
+  typedef typename remove_const<T>::type value_type;
+  static T *ptr(__gnu_cxx::__normal_iterator<T *, Container> it) {
+    return it.base();
+  }
+};
+#endif
+
+/*!
+ * True when It iterates over contiguous, writable elements of type T
+ */
+template <class It, class T, bool Contiguous = contiguous<It>::value>
+struct contiguous_of : false_type {};
+template <class It, class T>
+struct contiguous_of<It, T, true>
+    : bool_type<is_same<typename contiguous<It>::value_type, T>::value> {};
+
+/*!
+ * Hints that the element at it will be read soon. Only contiguous iterators
+ * can be turned into an address without touching memory; other iterators and
+ * builds defining ALGS_NO_PREFETCH make this a no-op.
+ */
+template <class It> inline void prefetch(It, false_type) {}
+
+/*!
+ * Size in bytes of a searched table or index below which queries skip the
+ * prefetches, since the whole of it likely stays in the L1 and L2 caches
+ */
+const std::ptrdiff_t prefetch_cutoff = 1 << 18;
+
+template <class It> inline void prefetch(It it, true_type) {
+#if defined(__GNUC__) && !defined(ALGS_NO_PREFETCH)
+  __builtin_prefetch(contiguous<It>::ptr(it));
+#else
+  (void)it;
+#endif
+}
+
+template <class It> inline void prefetch(It it) {
+  prefetch(it, bool_type<contiguous<It>::value>());
+}
+
+/*!
+ * Operations on one SIMD register of lanes of type T, for the types whose
+ * value equality is a lane-wise compare. The replace kernels are written
+ * against it, and translate uses its byte compares; the other SIMD kernels
+ * call the intrinsics they need directly.
+ */
+template <class T, bool Integral = is_integral<T>::value,
+          std::size_t Size = sizeof(T)>
+struct simd_lane : false_type {};
+
+#ifdef ALGS_SIMD
+#ifdef __AVX2__
+typedef __m256i simd_vec;
+
+inline simd_vec simd_load(const void *p) {
+  return _mm256_loadu_si256(static_cast<const simd_vec *>(p));
+}
+inline void simd_store(void *p, simd_vec v) {
+  _mm256_storeu_si256(static_cast<simd_vec *>(p), v);
+}
+/*! Lanes of b where mask m is set, lanes of a elsewhere */
+inline simd_vec simd_blend(simd_vec a, simd_vec b, simd_vec m) {
+  return _mm256_blendv_epi8(a, b, m);
+}
+/*! One bit per byte of v, set when the top bit of that byte is set */
+inline unsigned simd_movemask(simd_vec v) {
+  return static_cast<unsigned>(_mm256_movemask_epi8(v));
+}
+
+template <class T> struct simd_lane<T, true, 1> : true_type {
+  static simd_vec set1(T x) { return _mm256_set1_epi8(static_cast<char>(x)); }
+  static simd_vec eq(simd_vec a, simd_vec b) { return _mm256_cmpeq_epi8(a, b); }
+};
+template <class T> struct simd_lane<T, true, 2> : true_type {
+  static simd_vec set1(T x) {
+    return _mm256_set1_epi16(static_cast<short>(x));
+  }
+  static simd_vec eq(simd_vec a, simd_vec b) {
+    return _mm256_cmpeq_epi16(a, b);
+  }
+};
+template <class T> struct simd_lane<T, true, 4> : true_type {
+  static simd_vec set1(T x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+  static simd_vec eq(simd_vec a, simd_vec b) {
+    return _mm256_cmpeq_epi32(a, b);
+  }
+};
+template <class T> struct simd_lane<T, true, 8> : true_type {
+  static simd_vec set1(T x) {
+    return _mm256_set1_epi64x(static_cast<long long>(x));
+  }
+  static simd_vec eq(simd_vec a, simd_vec b) {
+    return _mm256_cmpeq_epi64(a, b);
+  }
+};
+template <> struct simd_lane<float, false, 4> : true_type {
+  static simd_vec set1(float x) {
+    return _mm256_castps_si256(_mm256_set1_ps(x));
+  }
+  static simd_vec eq(simd_vec a, simd_vec b) {
+    return _mm256_castps_si256(_mm256_cmp_ps(
+        _mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+  }
+};
+template <> struct simd_lane<double, false, 8> : true_type {
+  static simd_vec set1(double x) {
+    return _mm256_castpd_si256(_mm256_set1_pd(x));
+  }
+  static simd_vec eq(simd_vec a, simd_vec b) {
+    return _mm256_castpd_si256(_mm256_cmp_pd(
+        _mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+  }
+};
+#else
+typedef __m128i simd_vec;
+
+inline simd_vec simd_load(const void *p) {
+  return _mm_loadu_si128(static_cast<const simd_vec *>(p));
+}
+inline void simd_store(void *p, simd_vec v) {
+  _mm_storeu_si128(static_cast<simd_vec *>(p), v);
+}
+/*! Lanes of b where mask m is set, lanes of a elsewhere */
+inline simd_vec simd_blend(simd_vec a, simd_vec b, simd_vec m) {
+  return _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, a));
+}
+/*! One bit per byte of v, set when the top bit of that byte is set */
+inline unsigned simd_movemask(simd_vec v) {
+  return static_cast<unsigned>(_mm_movemask_epi8(v));
+}
+
+template <class T> struct simd_lane<T, true, 1> : true_type {
+  static simd_vec set1(T x) { return _mm_set1_epi8(static_cast<char>(x)); }
+  static simd_vec eq(simd_vec a, simd_vec b) { return _mm_cmpeq_epi8(a, b); }
+};
+template <class T> struct simd_lane<T, true, 2> : true_type {
+  static simd_vec set1(T x) { return _mm_set1_epi16(static_cast<short>(x)); }
+  static simd_vec eq(simd_vec a, simd_vec b) { return _mm_cmpeq_epi16(a, b); }
+};
+template <class T> struct simd_lane<T, true, 4> : true_type {
+  static simd_vec set1(T x) { return _mm_set1_epi32(static_cast<int>(x)); }
+  static simd_vec eq(simd_vec a, simd_vec b) { return _mm_cmpeq_epi32(a, b); }
+};
+template <class T> struct simd_lane<T, true, 8> : true_type {
+  static simd_vec set1(T x) {
+    return _mm_set1_epi64x(static_cast<long long>(x));
+  }
+  // SSE2 has no 64-bit compare: both 32-bit halves must match
+  static simd_vec eq(simd_vec a, simd_vec b) {
+    simd_vec m = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  }
+};
+template <> struct simd_lane<float, false, 4> : true_type {
+  static simd_vec set1(float x) { return _mm_castps_si128(_mm_set1_ps(x)); }
+  static simd_vec eq(simd_vec a, simd_vec b) {
+    return _mm_castps_si128(
+        _mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+  }
+};
+template <> struct simd_lane<double, false, 8> : true_type {
+  static simd_vec set1(double x) { return _mm_castpd_si128(_mm_set1_pd(x)); }
+  static simd_vec eq(simd_vec a, simd_vec b) {
+    return _mm_castpd_si128(
+        _mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+  }
+};
+#endif
+#endif
+
+} /* namespace detail */
+
 /*!
  * Test two sequences of the same length for equality.
  *
@@ -154,6 +550,7 @@ OutputIt remove_copy(InputIt b, InputIt e, OutputIt d, const X &x) {
       *d++ = *b;
     ++b;
   }
+  return d;
 }
 
 /*!
@@ -169,10 +566,11 @@ OutputIt remove_copy(InputIt b, InputIt e, OutputIt d, const X &x) {
 template <class InputIt, class OutputIt, class UnaryPred>
 OutputIt remove_copy_if(InputIt b, InputIt e, OutputIt d, UnaryPred p) {
   while (b != e) {
-    if (!p(b))
+    if (!p(*b))
       *d++ = *b;
     ++b;
   }
+  return d;
 }
 
 /*!
@@ -225,137 +623,5232 @@ ForwardIt remove_if(ForwardIt b, ForwardIt e, UnaryPred p) {
   return ret;
 }
 
+namespace detail {
+
+/*!
+ * Parallel task compacting one chunk of a range with the serial remove_if
+ */
+template <class RandomIt, class UnaryPred> struct remove_if_chunk {
+  RandomIt b;
+  std::ptrdiff_t n, k;
+  UnaryPred p;
+  std::ptrdiff_t *kept;
+
+  void operator()(std::ptrdiff_t i) const {
+    RandomIt cb = b + chunk_begin(n, k, i);
+    RandomIt ce = b + chunk_begin(n, k, i + 1);
+    kept[i] = algs::remove_if(cb, ce, p) - cb;
+  }
+};
+
+/*!
+ * Parallel task copy constructing the survivors of chunk i into a buffer, or
+ * assigning them back from the buffer to their final offset when back is set
+ */
+template <class RandomIt, class T> struct remove_if_move {
+  RandomIt b;
+  std::ptrdiff_t n, k, first;
+  const std::ptrdiff_t *kept, *offset;
+  T *buf;
+  bool back;
+
+  void operator()(std::ptrdiff_t i) const {
+    if (i < first)
+      return;
+    T *slot = buf + (offset[i] - offset[first]);
+    if (back)
+      algs::copy(slot, slot + kept[i], b + offset[i]);
+    else {
+      RandomIt cb = b + chunk_begin(n, k, i);
+      std::uninitialized_copy(cb, cb + kept[i], slot);
+    }
+  }
+};
+
+} /* namespace detail */
+
+/*!
+ * Parallel version of remove_if preserving the relative order of the kept
+ * elements. Chunks are compacted locally in parallel, then the survivors of
+ * every chunk are moved to their final offset in parallel through a temporary
+ * buffer; when no buffer can be obtained the move runs serially.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param p unary predicate function, called exactly once per element
+ *
+ * @returns a random access iter marking the new end of the range
+ */
+template <class RandomIt, class UnaryPred>
+RandomIt remove_if(const parallel_policy &, RandomIt b, RandomIt e,
+                   UnaryPred p) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  std::ptrdiff_t n = e - b;
+  std::ptrdiff_t k = detail::chunk_count(n);
+  if (k == 1)
+    return algs::remove_if(b, e, p);
+
+  std::vector<std::ptrdiff_t> kept(k), offset(k + 1);
+  detail::remove_if_chunk<RandomIt, UnaryPred> compact = {b, n, k, p, &kept[0]};
+  detail::parallel_for(k, compact);
+
+  // chunks before the first one with a removed element are already in place
+  std::ptrdiff_t first = k;
+  for (std::ptrdiff_t i = 0; i < k; ++i) {
+    offset[i + 1] = offset[i] + kept[i];
+    if (first == k && offset[i + 1] != detail::chunk_begin(n, k, i + 1))
+      first = i + 1;
+  }
+  if (first >= k)
+    return b + offset[k];
+
+  std::ptrdiff_t len = offset[k] - offset[first];
+  detail::temporary_buffer<T> buf(len);
+  if (buf.size() < len) {
+    // sliding the chunks left in order never overwrites an unmoved survivor
+    for (std::ptrdiff_t i = first; i < k; ++i) {
+      RandomIt cb = b + detail::chunk_begin(n, k, i);
+      algs::copy(cb, cb + kept[i], b + offset[i]);
+    }
+    return b + offset[k];
+  }
+
+  detail::remove_if_move<RandomIt, T> move = {
+      b, n, k, first, &kept[0], &offset[0], buf.data(), false};
+  detail::parallel_for(k, move);
+  buf.set_constructed(len);
+  move.back = true;
+  detail::parallel_for(k, move);
+  return b + offset[k];
+}
+
 /*!
- * Replaces all occurrences of x in the sequence [b,e) with y
+ * Alters the sequence of range [b,e) into one where all values that compare
+ * equal to x are removed, without preserving the order of the kept elements.
+ * Each hole is filled with a kept element taken from the back of the range, so
+ * the number of assignments is at most the number of removed elements.
  *
- * @param b forward iter marking the beginning of the sequence
- * @param e forward iter marking the end of the sequence
- * @param x const reference to value to be replaced
- * @param y const reference to replacement value
+ * @param b bidirectional iter marking the beginning of the sequence
+ * @param e bidirectional iter marking the end of the sequence
+ * @param x target value to be removed from sequence
+ *
+ * @returns a bidirectional iter marking the new end of the range
  */
-template <class ForwardIt, class X>
-void replace(ForwardIt b, ForwardIt e, const X &x, const X &y) {
-  while (b != e) {
-    if (*b == x)
-      *b = y;
+template <class BidirectionalIt, class X>
+BidirectionalIt unstable_remove(BidirectionalIt b, BidirectionalIt e,
+                                const X &x) {
+  while (true) {
+    while (b != e && !(*b == x))
+      ++b;
+    if (b == e)
+      return b;
+    do {
+      --e;
+      if (b == e)
+        return b;
+    } while (*e == x);
+    *b = *e;
     ++b;
   }
 }
 
 /*!
- * Transform sequence delimited by [b,e) such that all elements where prediated
- * p returns false are placed in the front of the sequence
+ * Alters the sequence of range [b,e) into one where all values where predicate
+ * p returns true are removed, without preserving the order of the kept
+ * elements. Each hole is filled with a kept element taken from the back of the
+ * range, so the number of assignments is at most the number of removed
+ * elements.
  *
  * @param b bidirectional iter marking the beginning of the sequence
  * @param e bidirectional iter marking the end of the sequence
- * @param p unary predicate function
+ * @param p unary predicate function, called at most once per element
  *
- * @returns a bidirectional iter pointing to first element of second partition
+ * @returns a bidirectional iter marking the new end of the range
  */
 template <class BidirectionalIt, class UnaryPred>
-BidirectionalIt partition(BidirectionalIt b, BidirectionalIt e, UnaryPred p) {
-  while (b != e) {
-    while (p(*b)) {
+BidirectionalIt unstable_remove_if(BidirectionalIt b, BidirectionalIt e,
+                                   UnaryPred p) {
+  while (true) {
+    while (b != e && !p(*b))
       ++b;
-      if (b == e)
-        return b;
-    }
+    if (b == e)
+      return b;
     do {
       --e;
       if (b == e)
         return b;
-    } while (!p(*e));
-    swap(*b, *e);
+    } while (p(*e));
+    *b = *e;
     ++b;
   }
-  return b;
 }
 
+namespace detail {
+
 /*!
- * Swaps the values of two generic elements x and y
+ * Unary predicate comparing its argument equal to a fixed value
+ */
+template <class X> struct equals {
+  const X &x;
+
+  explicit equals(const X &x) : x(x) {}
+
+  template <class Y> bool operator()(const Y &y) const { return y == x; }
+};
+
+} /* namespace detail */
+
+/*!
+ * Erases all elements of vector c where predicate p returns true by compacting
+ * the kept elements with remove_if and erasing the tail
  *
- * @param x reference to first value
- * @param y reference to second value
+ * @param c vector to erase elements from
+ * @param p unary predicate function
+ *
+ * @returns the number of erased elements
  */
-template <class X> void swap(X &x, X &y) {
-  X t = x;
-  x = y;
-  y = t;
+template <class T, class Alloc, class UnaryPred>
+typename std::vector<T, Alloc>::size_type erase_if(std::vector<T, Alloc> &c,
+                                                   UnaryPred p) {
+  typename std::vector<T, Alloc>::iterator it =
+      algs::remove_if(c.begin(), c.end(), p);
+  typename std::vector<T, Alloc>::size_type n = c.end() - it;
+  c.erase(it, c.end());
+  return n;
 }
 
+/*!
+ * Erases all elements of deque c where predicate p returns true. The kept
+ * elements between the first and the last erased element are compacted toward
+ * whichever end of the deque leaves fewer elements to shift, and the hole is
+ * then erased from that end.
+ *
+ * @param c deque to erase elements from
+ * @param p unary predicate function, called exactly once per element
+ *
+ * @returns the number of erased elements
+ */
+template <class T, class Alloc, class UnaryPred>
+typename std::deque<T, Alloc>::size_type erase_if(std::deque<T, Alloc> &c,
+                                                  UnaryPred p) {
+  typedef typename std::deque<T, Alloc>::iterator Iter;
+  typedef std::reverse_iterator<Iter> RevIter;
+  typename std::deque<T, Alloc>::size_type n = c.size();
+  Iter f = algs::find_if(c.begin(), c.end(), p);
+  if (f == c.end())
+    return 0;
+  Iter l = c.end();
+  do
+    --l;
+  while (l != f && !p(*l));
+
+  if (c.end() - l <= f - c.begin()) {
+    Iter d = f;
+    if (f != l)
+      d = algs::remove_copy_if(f + 1, l, d, p);
+    d = algs::copy(l + 1, c.end(), d);
+    c.erase(d, c.end());
+  } else {
+    RevIter d(l + 1);
+    if (f != l)
+      d = algs::remove_copy_if(RevIter(l), RevIter(f + 1), d, p);
+    d = algs::copy(RevIter(f), c.rend(), d);
+    c.erase(c.begin(), d.base());
+  }
+  return n - c.size();
+}
 
 /*!
- * Reverse the order of sequence [b,e)
+ * Erases all elements of list c where predicate p returns true by unlinking
+ * their nodes, without copying or assigning any element
  *
- * @param b iter marking the beginning of the sequence
- * @param e iter marking the end of the sequence
+ * @param c list to erase elements from
+ * @param p unary predicate function
+ *
+ * @returns the number of erased elements
  */
-template <class BidirectionalIt>
-void reverse(BidirectionalIt b, BidirectionalIt e) {
-  while (b != e) {
-    --e;
-    if (b != e)
-      swap(*b++, *e);
+template <class T, class Alloc, class UnaryPred>
+typename std::list<T, Alloc>::size_type erase_if(std::list<T, Alloc> &c,
+                                                 UnaryPred p) {
+  typename std::list<T, Alloc>::size_type n = 0;
+  typename std::list<T, Alloc>::iterator it = c.begin();
+  while (it != c.end()) {
+    if (p(*it)) {
+      it = c.erase(it);
+      ++n;
+    } else
+      ++it;
   }
+  return n;
 }
 
+#if __cplusplus >= 201103L
 /*!
- * Gathers the sum of sequence [b,e) into Accumulator a
+ * Erases all elements of forward list c where predicate p returns true by
+ * unlinking their nodes, without copying or assigning any element
  *
- * @param b iter marking the beginning of the sequence
- * @param e iter marking the end of the sequence
- * @param a accumulator holding the sum of the sequence
+ * @param c forward list to erase elements from
+ * @param p unary predicate function
  *
- * @returns the value of same type as the accumulator containing sum of the
- * sequence plus its initial value
+ * @returns the number of erased elements
  */
-template <class InputIt, class Accumulator>
-Accumulator accumulate(InputIt b, InputIt e, Accumulator &a) {
-  while (b != e)
-    a += *b++;
-  return a;
+template <class T, class Alloc, class UnaryPred>
+typename std::forward_list<T, Alloc>::size_type
+erase_if(std::forward_list<T, Alloc> &c, UnaryPred p) {
+  typename std::forward_list<T, Alloc>::size_type n = 0;
+  typename std::forward_list<T, Alloc>::iterator prev = c.before_begin();
+  typename std::forward_list<T, Alloc>::iterator it = c.begin();
+  while (it != c.end()) {
+    if (p(*it)) {
+      it = c.erase_after(prev);
+      ++n;
+    } else
+      prev = it++;
+  }
+  return n;
 }
+#endif
 
 /*!
- * Applies the function f to each element in the sequence [b,e)
+ * Erases all elements of container c that compare equal to x, using the
+ * erase_if overload suited to the container
  *
- * @param b input iter marking the beginning of the sequence
- * @param e input iter marking the end of the sequence
- * @param f function to be apllied to each element
+ * @param c vector, deque, list or forward list to erase elements from
+ * @param x target value to be erased from the container
  *
- * @returns function f
+ * @returns the number of erased elements
  */
-template <class InputIt, class Function>
-Function for_each(InputIt b, InputIt e, Function f) {
+template <class Container, class X>
+typename Container::size_type erase(Container &c, const X &x) {
+  return algs::erase_if(c, detail::equals<X>(x));
+}
+
+namespace detail {
+
+/*!
+ * Copies [b,e) to d, writing y in place of every element where p returns true.
+ * d may equal b to replace in place.
+ */
+template <class InputIt, class OutputIt, class UnaryPred, class X>
+OutputIt replace_copy_if(InputIt b, InputIt e, OutputIt d, UnaryPred p,
+                         const X &y, false_type) {
   while (b != e) {
-    f(*b);
+    if (p(*b))
+      *d = y;
+    else
+      *d = *b;
+    ++d;
     ++b;
   }
-  return f;
+  return d;
 }
 
 /*!
- * Performs simple binary search on sequence [b,e)
- *
- * @param b iter marking the beginning of the sequence
- * @param e iter marking the end of the sequence
- * @param x target value for search
- *
- * @returns true if target value was found, otherwise false
+ * Contiguous arithmetic version of the loop above which always stores, either
+ * the element or y, so the select compiles to a blend instead of a branch
  */
-template <class RandomIt, class X>
-bool binary_search(RandomIt b, RandomIt e, const X &x) {
-  while (b < e) {
-    // this calculation of mid avoids integer overflow
-    RandomIt mid = b + (e - b) / 2;
-    if (x < *mid)
-      e = mid;
-    else if (*mid < x)
-      b = mid + 1;
+template <class InputIt, class OutputIt, class UnaryPred, class X>
+OutputIt replace_copy_if(InputIt b, InputIt e, OutputIt d, UnaryPred p,
+                         const X &y, true_type) {
+  const X *s = contiguous<InputIt>::ptr(b);
+  const X *se = contiguous<InputIt>::ptr(e);
+  X *t = contiguous<OutputIt>::ptr(d);
+  for (; s != se; ++s, ++t) {
+    X v = *s;
+    *t = p(v) ? y : v;
+  }
+  return d + (se - contiguous<InputIt>::ptr(b));
+}
+
+template <class InputIt, class OutputIt, class X>
+OutputIt replace_copy(InputIt b, InputIt e, OutputIt d, const X &x,
+                      const X &y, false_type) {
+  while (b != e) {
+    if (*b == x)
+      *d = y;
     else
-      return true;
+      *d = *b;
+    ++d;
+    ++b;
   }
-  return false;
+  return d;
+}
+
+#ifdef ALGS_SIMD
+/*!
+ * Compare-and-blend kernel for replacing x with y in contiguous arithmetic
+ * data. When replacing in place, registers without a match are not stored so
+ * unchanged cache lines stay clean.
+ */
+template <class InputIt, class OutputIt, class X>
+OutputIt replace_copy(InputIt b, InputIt e, OutputIt d, const X &x,
+                      const X &y, true_type) {
+  const std::ptrdiff_t w = sizeof(simd_vec) / sizeof(X);
+  const X *s = contiguous<InputIt>::ptr(b);
+  const X *se = contiguous<InputIt>::ptr(e);
+  X *t = contiguous<OutputIt>::ptr(d);
+  bool in_place = s == t;
+  simd_vec vx = simd_lane<X>::set1(x), vy = simd_lane<X>::set1(y);
+  for (; se - s >= w; s += w, t += w) {
+    simd_vec v = simd_load(s);
+    simd_vec m = simd_lane<X>::eq(v, vx);
+    if (!in_place || simd_movemask(m))
+      simd_store(t, simd_blend(v, vy, m));
+  }
+  for (; s != se; ++s, ++t)
+    *t = *s == x ? y : *s;
+  return d + (se - contiguous<InputIt>::ptr(b));
+}
+#endif
+
+/*!
+ * True when copying from InputIt to OutputIt while replacing values of type X
+ * can use the compare-and-blend kernel
+ */
+template <class InputIt, class OutputIt, class X> struct replace_simd {
+  static const bool value = contiguous_of<InputIt, X>::value &&
+                            contiguous_of<OutputIt, X>::value &&
+                            simd_lane<X>::value;
+};
+
+template <class ForwardIt, class X>
+void replace(ForwardIt b, ForwardIt e, const X &x, const X &y, false_type) {
+  while (b != e) {
+    if (*b == x)
+      *b = y;
+    ++b;
+  }
+}
+
+template <class ForwardIt, class X>
+void replace(ForwardIt b, ForwardIt e, const X &x, const X &y, true_type) {
+  detail::replace_copy(b, e, b, x, y, true_type());
+}
+
+/*!
+ * True when the replace_if select loop may run over plain pointers
+ */
+template <class InputIt, class OutputIt, class X> struct replace_select {
+  static const bool value =
+      contiguous_of<InputIt, X>::value && contiguous_of<OutputIt, X>::value &&
+      (is_integral<X>::value || is_same<X, float>::value ||
+       is_same<X, double>::value);
+};
+
+} /* namespace detail */
+
+/*!
+ * Replaces all occurrences of x in the sequence [b,e) with y. Contiguous
+ * arithmetic data is processed with a SIMD compare-and-blend kernel.
+ *
+ * @param b forward iter marking the beginning of the sequence
+ * @param e forward iter marking the end of the sequence
+ * @param x const reference to value to be replaced
+ * @param y const reference to replacement value
+ */
+template <class ForwardIt, class X>
+void replace(ForwardIt b, ForwardIt e, const X &x, const X &y) {
+  detail::replace(
+      b, e, x, y,
+      detail::bool_type<detail::replace_simd<ForwardIt, ForwardIt, X>::value>());
+}
+
+/*!
+ * Replaces every element of the sequence [b,e) where predicate p returns true
+ * with y
+ *
+ * @param b forward iter marking the beginning of the sequence
+ * @param e forward iter marking the end of the sequence
+ * @param p unary predicate function
+ * @param y const reference to replacement value
+ */
+template <class ForwardIt, class UnaryPred, class X>
+void replace_if(ForwardIt b, ForwardIt e, UnaryPred p, const X &y) {
+  detail::replace_copy_if(
+      b, e, b, p, y,
+      detail::bool_type<
+          detail::replace_select<ForwardIt, ForwardIt, X>::value>());
+}
+
+/*!
+ * Copies the sequence [b,e) to d, writing y in place of every element that
+ * compares equal to x
+ *
+ * @param b input iter marking the beginning of the source sequence
+ * @param e input iter marking the end of the source sequence
+ * @param d output iter marking the beginning of the destination sequence
+ * @param x const reference to value to be replaced
+ * @param y const reference to replacement value
+ *
+ * @returns an output iter marking the end of the copied sequence
+ */
+template <class InputIt, class OutputIt, class X>
+OutputIt replace_copy(InputIt b, InputIt e, OutputIt d, const X &x,
+                      const X &y) {
+  return detail::replace_copy(
+      b, e, d, x, y,
+      detail::bool_type<detail::replace_simd<InputIt, OutputIt, X>::value>());
+}
+
+/*!
+ * Copies the sequence [b,e) to d, writing y in place of every element where
+ * predicate p returns true
+ *
+ * @param b input iter marking the beginning of the source sequence
+ * @param e input iter marking the end of the source sequence
+ * @param d output iter marking the beginning of the destination sequence
+ * @param p unary predicate function
+ * @param y const reference to replacement value
+ *
+ * @returns an output iter marking the end of the copied sequence
+ */
+template <class InputIt, class OutputIt, class UnaryPred, class X>
+OutputIt replace_copy_if(InputIt b, InputIt e, OutputIt d, UnaryPred p,
+                         const X &y) {
+  return detail::replace_copy_if(
+      b, e, d, p, y,
+      detail::bool_type<
+          detail::replace_select<InputIt, OutputIt, X>::value>());
+}
+
+/*!
+ * Byte to byte mapping applied in a single pass by translate(), initially the
+ * identity. Any number of replace calls over the same byte range can be folded
+ * into one table.
+ */
+class translation_table {
+public:
+  translation_table() {
+    for (int i = 0; i < 256; ++i)
+      table[i] = static_cast<unsigned char>(i);
+  }
+
+  /*!
+   * Maps byte x to byte y, overriding the current mapping of x
+   *
+   * @param x source byte
+   * @param y destination byte
+   */
+  void set(unsigned char x, unsigned char y) { table[x] = y; }
+
+  /*!
+   * Composes the table with replacing x by y, so that translating with the
+   * table has the effect of the previous mappings followed by replace(b,e,x,y)
+   *
+   * @param x byte to be replaced
+   * @param y replacement byte
+   */
+  void replace(unsigned char x, unsigned char y) {
+    for (int i = 0; i < 256; ++i)
+      if (table[i] == x)
+        table[i] = y;
+  }
+
+  /*!
+   * @returns the byte that x is mapped to
+   */
+  unsigned char operator[](unsigned char x) const { return table[x]; }
+
+private:
+  unsigned char table[256];
+};
+
+namespace detail {
+
+template <class ForwardIt>
+void translate(ForwardIt b, ForwardIt e, const translation_table &t,
+               false_type) {
+  typedef typename std::iterator_traits<ForwardIt>::value_type T;
+  while (b != e) {
+    *b = static_cast<T>(t[static_cast<unsigned char>(*b)]);
+    ++b;
+  }
+}
+
+template <class ForwardIt>
+void translate(ForwardIt b, ForwardIt e, const translation_table &t,
+               true_type) {
+  unsigned char *s = reinterpret_cast<unsigned char *>(
+      contiguous<ForwardIt>::ptr(b));
+  unsigned char *se = reinterpret_cast<unsigned char *>(
+      contiguous<ForwardIt>::ptr(e));
+#if defined(ALGS_SIMD) && defined(__SSSE3__)
+  // Each group of 16 bytes sharing the high nibble is one table row, and a
+  // row is applied to a register with a byte shuffle indexed by the low
+  // nibble. Rows mapping to themselves are skipped, so this pays off while
+  // only a few rows differ from the identity.
+  const int max_rows = 8;
+  simd_vec rows[max_rows], nibbles[max_rows];
+  unsigned char row[16];
+  int active = 0;
+  for (int h = 0; h < 16 && active <= max_rows; ++h) {
+    bool identity = true;
+    for (int l = 0; l < 16; ++l) {
+      row[l] = t[static_cast<unsigned char>(h * 16 + l)];
+      identity = identity && row[l] == h * 16 + l;
+    }
+    if (identity)
+      continue;
+    if (active < max_rows) {
+      __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row));
+#ifdef __AVX2__
+      rows[active] = _mm256_broadcastsi128_si256(r);
+#else
+      rows[active] = r;
+#endif
+      nibbles[active] = simd_lane<unsigned char>::set1(
+          static_cast<unsigned char>(h));
+    }
+    ++active;
+  }
+  if (active == 0)
+    return;
+  if (active <= max_rows) {
+    const std::ptrdiff_t w = sizeof(simd_vec);
+    simd_vec low = simd_lane<unsigned char>::set1(0x0F);
+    for (; se - s >= w; s += w) {
+      simd_vec v = simd_load(s);
+#ifdef __AVX2__
+      simd_vec lo = _mm256_and_si256(v, low);
+      simd_vec hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+#else
+      simd_vec lo = _mm_and_si128(v, low);
+      simd_vec hi = _mm_and_si128(_mm_srli_epi16(v, 4), low);
+#endif
+      simd_vec r = v;
+      for (int k = 0; k < active; ++k) {
+        simd_vec m = simd_lane<unsigned char>::eq(hi, nibbles[k]);
+#ifdef __AVX2__
+        simd_vec u = _mm256_shuffle_epi8(rows[k], lo);
+#else
+        simd_vec u = _mm_shuffle_epi8(rows[k], lo);
+#endif
+        r = simd_blend(r, u, m);
+      }
+      simd_store(s, r);
+    }
+  }
+#endif
+  for (; s != se; ++s)
+    *s = t[*s];
+}
+
+/*!
+ * True when ForwardIt iterates over contiguous, writable bytes
+ */
+template <class ForwardIt, bool Contiguous = contiguous<ForwardIt>::value>
+struct byte_range : false_type {};
+template <class ForwardIt>
+struct byte_range<ForwardIt, true>
+    : bool_type<is_integral<typename contiguous<ForwardIt>::value_type>::value &&
+                sizeof(typename contiguous<ForwardIt>::value_type) == 1> {};
+
+} /* namespace detail */
+
+/*!
+ * Maps every byte in the sequence [b,e) through translation table t in a
+ * single pass. Contiguous byte ranges are translated with SIMD byte shuffles
+ * when few rows of the table differ from the identity.
+ *
+ * @param b forward iter over char sized elements marking the beginning of the
+ * sequence
+ * @param e forward iter marking the end of the sequence
+ * @param t translation table to apply
+ */
+template <class ForwardIt>
+void translate(ForwardIt b, ForwardIt e, const translation_table &t) {
+  detail::translate(b, e, t,
+                    detail::bool_type<detail::byte_range<ForwardIt>::value>());
+}
+
+/*!
+ * Swaps the values of two generic elements x and y
+ *
+ * @param x reference to first value
+ * @param y reference to second value
+ */
+template <class X> void swap(X &x, X &y) {
+  X t = x;
+  x = y;
+  y = t;
+}
+
+namespace detail {
+
+template <class BidirectionalIt, class UnaryPred>
+BidirectionalIt partition(BidirectionalIt b, BidirectionalIt e, UnaryPred p,
+                          std::bidirectional_iterator_tag) {
+  while (b != e) {
+    while (p(*b)) {
+      ++b;
+      if (b == e)
+        return b;
+    }
+    do {
+      --e;
+      if (b == e)
+        return b;
+    } while (!p(*e));
+    algs::swap(*b, *e);
+    ++b;
+  }
+  return b;
+}
+
+/*!
+ * Number of elements scanned at a time from each end by the block partition
+ */
+const int partition_block = 64;
+
+/*!
+ * Block partition in the style of BlockQuicksort. A block at each end of the
+ * range is scanned without branching on the predicate, recording the offsets
+ * of the misplaced elements, and the recorded elements are then exchanged in
+ * bulk with a cyclic permutation. The final few blocks are finished by the
+ * Hoare loop above, which may apply p a second time to some of them.
+ */
+template <class RandomIt, class UnaryPred>
+RandomIt partition(RandomIt b, RandomIt e, UnaryPred p,
+                   std::random_access_iterator_tag) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  unsigned char off_l[partition_block], off_r[partition_block];
+  int start_l = 0, start_r = 0, num_l = 0, num_r = 0;
+  while (e - b > 2 * partition_block) {
+    if (num_l == 0) {
+      start_l = 0;
+      for (int i = 0; i < partition_block; ++i) {
+        off_l[num_l] = static_cast<unsigned char>(i);
+        num_l += !p(b[i]);
+      }
+    }
+    if (num_r == 0) {
+      start_r = 0;
+      for (int i = 0; i < partition_block; ++i) {
+        off_r[num_r] = static_cast<unsigned char>(i);
+        num_r += !!p(*(e - 1 - i));
+      }
+    }
+    int num = num_l < num_r ? num_l : num_r;
+    if (num > 0) {
+      const unsigned char *l = off_l + start_l, *r = off_r + start_r;
+      T t = b[l[0]];
+      b[l[0]] = *(e - 1 - r[0]);
+      for (int k = 1; k < num; ++k) {
+        *(e - 1 - r[k - 1]) = b[l[k]];
+        b[l[k]] = *(e - 1 - r[k]);
+      }
+      *(e - 1 - r[num - 1]) = t;
+    }
+    num_l -= num;
+    num_r -= num;
+    start_l += num;
+    start_r += num;
+    if (num_l == 0)
+      b += partition_block;
+    if (num_r == 0)
+      e -= partition_block;
+  }
+  return detail::partition(b, e, p, std::bidirectional_iterator_tag());
+}
+
+} /* namespace detail */
+
+/*!
+ * Transform sequence delimited by [b,e) such that all elements where predicate
+ * p returns true are placed in the front of the sequence. Random access ranges
+ * are partitioned block-wise without branching on the predicate.
+ *
+ * @param b bidirectional iter marking the beginning of the sequence
+ * @param e bidirectional iter marking the end of the sequence
+ * @param p unary predicate function
+ *
+ * @returns a bidirectional iter pointing to first element of second partition
+ */
+template <class BidirectionalIt, class UnaryPred>
+BidirectionalIt partition(BidirectionalIt b, BidirectionalIt e, UnaryPred p) {
+  return detail::partition(
+      b, e, p,
+      typename std::iterator_traits<BidirectionalIt>::iterator_category());
+}
+
+namespace detail {
+
+/*!
+ * Parallel task partitioning one chunk of a range with the serial partition
+ */
+template <class RandomIt, class UnaryPred> struct partition_chunk {
+  RandomIt b;
+  std::ptrdiff_t n, k;
+  UnaryPred p;
+  std::ptrdiff_t *kept;
+
+  void operator()(std::ptrdiff_t i) const {
+    RandomIt cb = b + chunk_begin(n, k, i);
+    kept[i] = algs::partition(cb, b + chunk_begin(n, k, i + 1), p) - cb;
+  }
+};
+
+typedef std::vector<std::pair<std::ptrdiff_t, std::ptrdiff_t> > interval_list;
+
+/*!
+ * Parallel task swapping the misplaced elements numbered [lo,hi) on the left
+ * of the partition point with the ones with the same numbers on the right.
+ * Both sets are given as ordered lists of offset intervals.
+ */
+template <class RandomIt> struct partition_fixup {
+  RandomIt b;
+  std::ptrdiff_t len, k;
+  const interval_list *left, *right;
+
+  // locate the interval holding element number x and the offset within it
+  static void seek(const interval_list &l, std::ptrdiff_t x, std::size_t &i,
+                   std::ptrdiff_t &at) {
+    i = 0;
+    while (x >= l[i].second - l[i].first) {
+      x -= l[i].second - l[i].first;
+      ++i;
+    }
+    at = l[i].first + x;
+  }
+
+  void operator()(std::ptrdiff_t j) const {
+    std::ptrdiff_t lo = chunk_begin(len, k, j), hi = chunk_begin(len, k, j + 1);
+    if (lo == hi)
+      return;
+    std::size_t li, ri;
+    std::ptrdiff_t l, r;
+    seek(*left, lo, li, l);
+    seek(*right, lo, ri, r);
+    for (std::ptrdiff_t c = hi - lo; c > 0; --c) {
+      while (l == (*left)[li].second)
+        l = (*left)[++li].first;
+      while (r == (*right)[ri].second)
+        r = (*right)[++ri].first;
+      algs::swap(b[l++], b[r++]);
+    }
+  }
+};
+
+} /* namespace detail */
+
+/*!
+ * Parallel version of partition. Every chunk of the range is partitioned by a
+ * thread with the block partition, then the elements left on the wrong side
+ * of the final partition point are swapped across it in parallel.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param p unary predicate function
+ *
+ * @returns a random access iter pointing to first element of second partition
+ */
+template <class RandomIt, class UnaryPred>
+RandomIt partition(const parallel_policy &, RandomIt b, RandomIt e,
+                   UnaryPred p) {
+  std::ptrdiff_t n = e - b;
+  std::ptrdiff_t k = detail::chunk_count(n);
+  if (k == 1)
+    return algs::partition(b, e, p);
+
+  std::vector<std::ptrdiff_t> kept(k);
+  detail::partition_chunk<RandomIt, UnaryPred> part = {b, n, k, p, &kept[0]};
+  detail::parallel_for(k, part);
+
+  std::ptrdiff_t m = 0;
+  for (std::ptrdiff_t i = 0; i < k; ++i)
+    m += kept[i];
+
+  // chunk i holds true elements in [cb,cm) and false elements in [cm,ce)
+  detail::interval_list left, right;
+  std::ptrdiff_t misplaced = 0;
+  for (std::ptrdiff_t i = 0; i < k; ++i) {
+    std::ptrdiff_t cb = detail::chunk_begin(n, k, i);
+    std::ptrdiff_t cm = cb + kept[i];
+    std::ptrdiff_t ce = detail::chunk_begin(n, k, i + 1);
+    if (cm < m) {
+      std::ptrdiff_t end = ce < m ? ce : m;
+      left.push_back(std::make_pair(cm, end));
+      misplaced += end - cm;
+    }
+    if (cm > m)
+      right.push_back(std::make_pair(cb > m ? cb : m, cm));
+  }
+  if (misplaced > 0) {
+    detail::partition_fixup<RandomIt> fix = {b, misplaced, k, &left, &right};
+    detail::parallel_for(k, fix);
+  }
+  return b + m;
+}
+
+/*!
+ * Reverse the order of sequence [b,e)
+ *
+ * @param b iter marking the beginning of the sequence
+ * @param e iter marking the end of the sequence
+ */
+template <class BidirectionalIt>
+void reverse(BidirectionalIt b, BidirectionalIt e) {
+  while (b != e) {
+    --e;
+    if (b != e)
+      swap(*b++, *e);
+  }
+}
+
+/*!
+ * Rotates the sequence [b,e) so that m becomes its first element, by reversing
+ * both halves and then the whole sequence
+ *
+ * @param b bidirectional iter marking the beginning of the sequence
+ * @param m bidirectional iter marking the element to become the first
+ * @param e bidirectional iter marking the end of the sequence
+ *
+ * @returns a bidirectional iter marking the new position of the element
+ * previously at b
+ */
+template <class BidirectionalIt>
+BidirectionalIt rotate(BidirectionalIt b, BidirectionalIt m,
+                       BidirectionalIt e) {
+  if (b == m)
+    return e;
+  if (m == e)
+    return b;
+  algs::reverse(b, m);
+  algs::reverse(m, e);
+  while (b != m && m != e)
+    algs::swap(*b++, *--e);
+  if (b == m) {
+    algs::reverse(m, e);
+    return e;
+  }
+  algs::reverse(b, m);
+  return b;
+}
+
+namespace detail {
+
+/*!
+ * Stable partition of the n elements of [b,e) using buffer buf of len
+ * constructed elements. Ranges fitting in the buffer are partitioned in one
+ * linear pass; longer ones are split in halves whose partitions are joined
+ * with a rotation, which with no buffer at all gives O(n log n) swaps.
+ */
+template <class BidirectionalIt, class UnaryPred, class T>
+BidirectionalIt stable_partition(BidirectionalIt b, BidirectionalIt e,
+                                 UnaryPred &p, std::ptrdiff_t n, T *buf,
+                                 std::ptrdiff_t len) {
+  if (n == 1)
+    return p(*b) ? e : b;
+  if (n <= len) {
+    BidirectionalIt d = b;
+    T *t = buf;
+    for (; b != e; ++b) {
+      if (p(*b))
+        *d++ = *b;
+      else
+        *t++ = *b;
+    }
+    algs::copy(buf, t, d);
+    return d;
+  }
+  BidirectionalIt m = b;
+  std::advance(m, n / 2);
+  BidirectionalIt l = detail::stable_partition(b, m, p, n / 2, buf, len);
+  BidirectionalIt r = detail::stable_partition(m, e, p, n - n / 2, buf, len);
+  return algs::rotate(l, m, r);
+}
+
+} /* namespace detail */
+
+/*!
+ * Transform sequence delimited by [b,e) such that all elements where predicate
+ * p returns true are placed in the front of the sequence, preserving the
+ * relative order within both groups. Runs in linear time when a temporary
+ * buffer for the range can be allocated, and degrades to an in-place
+ * O(n log n) algorithm otherwise.
+ *
+ * @param b bidirectional iter marking the beginning of the sequence
+ * @param e bidirectional iter marking the end of the sequence
+ * @param p unary predicate function, called exactly once per element
+ *
+ * @returns a bidirectional iter pointing to first element of second partition
+ */
+template <class BidirectionalIt, class UnaryPred>
+BidirectionalIt stable_partition(BidirectionalIt b, BidirectionalIt e,
+                                 UnaryPred p) {
+  typedef typename std::iterator_traits<BidirectionalIt>::value_type T;
+  while (b != e && p(*b))
+    ++b;
+  if (b == e)
+    return b;
+  // *b is already known to be in the second group
+  BidirectionalIt f = b;
+  ++f;
+  std::ptrdiff_t n = std::distance(f, e);
+  if (n == 0)
+    return b;
+  detail::temporary_buffer<T> buf(n);
+  if (buf.size() > 0)
+    buf.fill(*b);
+  BidirectionalIt m =
+      detail::stable_partition(f, e, p, n, buf.data(), buf.size());
+  return algs::rotate(b, f, m);
+}
+
+/*!
+ * Stable partition of [b,e) as above, using a caller-owned scratch buffer
+ * instead of allocating one. A buffer of as many elements as the range gives
+ * linear time; a shorter one, or none, is used for the largest subranges that
+ * fit.
+ *
+ * @param b bidirectional iter marking the beginning of the sequence
+ * @param e bidirectional iter marking the end of the sequence
+ * @param p unary predicate function, called exactly once per element
+ * @param buf pointer to len constructed elements that may be overwritten
+ * @param len number of elements in the scratch buffer
+ *
+ * @returns a bidirectional iter pointing to first element of second partition
+ */
+template <class BidirectionalIt, class UnaryPred, class T>
+BidirectionalIt stable_partition(BidirectionalIt b, BidirectionalIt e,
+                                 UnaryPred p, T *buf, std::ptrdiff_t len) {
+  std::ptrdiff_t n = std::distance(b, e);
+  if (n == 0)
+    return b;
+  return detail::stable_partition(b, e, p, n, buf, len);
+}
+
+/*!
+ * Partitions the sequence [b,e) into elements less than x, elements
+ * equivalent to x and elements greater than x, in that order (Dutch national
+ * flag)
+ *
+ * @param b bidirectional iter marking the beginning of the sequence
+ * @param e bidirectional iter marking the end of the sequence
+ * @param x pivot value, copied so it may refer into the sequence
+ * @param c comparator function
+ *
+ * @returns a pair of bidirectional iters marking the beginning and the end of
+ * the elements equivalent to x
+ */
+template <class BidirectionalIt, class X, class Compare>
+std::pair<BidirectionalIt, BidirectionalIt>
+three_way_partition(BidirectionalIt b, BidirectionalIt e, const X &x,
+                    Compare c) {
+  X pivot(x);
+  BidirectionalIt i = b;
+  while (i != e) {
+    if (c(*i, pivot)) {
+      if (b != i)
+        algs::swap(*b, *i);
+      ++b;
+      ++i;
+    } else if (c(pivot, *i)) {
+      --e;
+      algs::swap(*i, *e);
+    } else
+      ++i;
+  }
+  return std::make_pair(b, e);
+}
+
+/*!
+ * Partitions the sequence [b,e) into elements less than x, elements equal to
+ * x and elements greater than x using operator<
+ *
+ * @param b bidirectional iter marking the beginning of the sequence
+ * @param e bidirectional iter marking the end of the sequence
+ * @param x pivot value, copied so it may refer into the sequence
+ *
+ * @returns a pair of bidirectional iters marking the beginning and the end of
+ * the elements equal to x
+ */
+template <class BidirectionalIt, class X>
+std::pair<BidirectionalIt, BidirectionalIt>
+three_way_partition(BidirectionalIt b, BidirectionalIt e, const X &x) {
+  return algs::three_way_partition(b, e, x, detail::less());
+}
+
+/*!
+ * Distributes the sequence [b,e) in place into k buckets, ordered by the
+ * bucket index that classifier f assigns to each element. One pass counts the
+ * bucket sizes, a second moves every element directly into its bucket by
+ * following permutation cycles (American flag sort). The order within a
+ * bucket is not preserved.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param k number of buckets
+ * @param f classifier function mapping an element to a bucket in [0,k)
+ * @param bounds random access iter receiving the k + 1 offsets of the bucket
+ * boundaries, the last one being e - b
+ */
+template <class RandomIt, class Classifier, class SizeIt>
+void bucket_partition(RandomIt b, RandomIt e, std::size_t k, Classifier f,
+                      SizeIt bounds) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  std::vector<std::size_t> next(k + 1);
+  for (RandomIt it = b; it != e; ++it)
+    ++next[f(*it) + 1];
+  for (std::size_t i = 0; i < k; ++i)
+    next[i + 1] += next[i];
+  std::vector<std::size_t> end(next.begin() + 1, next.end());
+  for (std::size_t i = 0; i <= k; ++i)
+    bounds[i] = next[i];
+  for (std::size_t i = 0; i < k; ++i) {
+    while (next[i] < end[i]) {
+      std::size_t j = f(b[next[i]]);
+      if (j == i) {
+        ++next[i];
+        continue;
+      }
+      // carry the element along its cycle until one belongs to bucket i
+      T t = b[next[i]];
+      do {
+        algs::swap(t, b[next[j]++]);
+        j = f(t);
+      } while (j != i);
+      b[next[i]++] = t;
+    }
+  }
+}
+
+/*!
+ * Number of elements staged per bucket by bucket_partition_copy
+ */
+const std::size_t bucket_buffer = 16;
+
+/*!
+ * Distributes the sequence [b,e) into k buckets written to d, ordered by the
+ * bucket index that classifier f assigns to each element and keeping the
+ * relative order within each bucket. One pass counts the bucket sizes and a
+ * second scatters the elements, staging them in small per-bucket buffers so
+ * that every bucket is written in contiguous bursts.
+ *
+ * @param b random access iter marking the beginning of the source sequence
+ * @param e random access iter marking the end of the source sequence
+ * @param d random access iter marking the beginning of the destination
+ * @param k number of buckets
+ * @param f classifier function mapping an element to a bucket in [0,k)
+ * @param bounds random access iter receiving the k + 1 offsets of the bucket
+ * boundaries, the last one being e - b
+ *
+ * @returns a random access iter marking the end of the destination sequence
+ */
+template <class RandomIt, class OutputIt, class Classifier, class SizeIt>
+OutputIt bucket_partition_copy(RandomIt b, RandomIt e, OutputIt d,
+                               std::size_t k, Classifier f, SizeIt bounds) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  std::vector<std::size_t> next(k + 1), fill(k);
+  for (RandomIt it = b; it != e; ++it)
+    ++next[f(*it) + 1];
+  for (std::size_t i = 0; i < k; ++i)
+    next[i + 1] += next[i];
+  for (std::size_t i = 0; i <= k; ++i)
+    bounds[i] = next[i];
+  if (b == e)
+    return d;
+  std::vector<T> stage(k * bucket_buffer, *b);
+  for (RandomIt it = b; it != e; ++it) {
+    std::size_t j = f(*it);
+    T *s = &stage[j * bucket_buffer];
+    s[fill[j]++] = *it;
+    if (fill[j] == bucket_buffer) {
+      algs::copy(s, s + bucket_buffer, d + next[j]);
+      next[j] += bucket_buffer;
+      fill[j] = 0;
+    }
+  }
+  for (std::size_t j = 0; j < k; ++j) {
+    const T *s = &stage[j * bucket_buffer];
+    algs::copy(s, s + fill[j], d + next[j]);
+  }
+  return d + (e - b);
+}
+
+namespace detail {
+
+/*!
+ * Tuning constants of the pattern-defeating quicksort
+ */
+const std::ptrdiff_t insertion_sort_threshold = 24;
+const std::ptrdiff_t ninther_threshold = 128;
+const std::ptrdiff_t partial_insertion_sort_limit = 8;
+
+/*!
+ * Insertion sort of [b,e). When unguarded, an element not greater than any
+ * element of the range must precede b, and the scan relies on it to stop.
+ */
+template <class RandomIt, class Compare>
+void insertion_sort(RandomIt b, RandomIt e, Compare &c, bool unguarded) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  if (b == e)
+    return;
+  for (RandomIt it = b + 1; it != e; ++it) {
+    RandomIt hole = it, prev = it - 1;
+    if (c(*hole, *prev)) {
+      T t = *hole;
+      do
+        *hole-- = *prev;
+      while ((unguarded || hole != b) && c(t, *--prev));
+      *hole = t;
+    }
+  }
+}
+
+/*!
+ * Insertion sort of [b,e) that gives up once more than a few elements had to
+ * be moved
+ *
+ * @returns true if the range was sorted
+ */
+template <class RandomIt, class Compare>
+bool partial_insertion_sort(RandomIt b, RandomIt e, Compare &c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  if (b == e)
+    return true;
+  std::ptrdiff_t moved = 0;
+  for (RandomIt it = b + 1; it != e; ++it) {
+    RandomIt hole = it, prev = it - 1;
+    if (c(*hole, *prev)) {
+      T t = *hole;
+      do
+        *hole-- = *prev;
+      while (hole != b && c(t, *--prev));
+      *hole = t;
+      moved += it - hole;
+    }
+    if (moved > partial_insertion_sort_limit)
+      return false;
+  }
+  return true;
+}
+
+/*!
+ * Longest block the sorting networks sort at once, and the length below which
+ * the quicksort hands a slice to them instead of the insertion sort
+ */
+const std::ptrdiff_t sort_network_max = 256;
+const std::ptrdiff_t sort_network_threshold = 256;
+
+/*!
+ * Register operations of the bitonic sorting networks for one element type:
+ * loading and storing a register of lanes, loading only its first t lanes with
+ * the others set to the largest value of the type, sort2 sorting the lanes of
+ * two registers pairwise into their minima and maxima, exchange<X> moving
+ * lane l ^ X into lane l, and pair<X,Bit> sorting each pair of lanes l and
+ * l ^ X of one register, the smaller value going to the lane whose index has
+ * Bit clear. Types without a specialization are sorted by the scalar code.
+ */
+template <class T> struct sort_network : false_type {};
+
+/*!
+ * Mask of the first Lanes lanes whose index has Bit set
+ */
+template <int Bit, int Lanes> struct lane_mask {
+  static const int value = ((Lanes - 1) & Bit ? 1 << (Lanes - 1) : 0) |
+                           lane_mask<Bit, Lanes - 1>::value;
+};
+template <int Bit> struct lane_mask<Bit, 0> {
+  static const int value = 0;
+};
+
+/*!
+ * Immediate operand of a shuffle of four lanes moving lane l ^ X into lane l
+ */
+template <int X> struct lane_shuffle {
+  static const int value = ((0 ^ X) & 3) | ((1 ^ X) & 3) << 2 |
+                           ((2 ^ X) & 3) << 4 | ((3 ^ X) & 3) << 6;
+};
+
+#if defined(ALGS_SIMD) && defined(__AVX2__)
+// Floating point lanes are ordered by a compare and blends rather than min and
+// max instructions, which would turn -0.0 into 0.0 or the reverse, and both
+// lanes of a pair compare the same way round, so that they agree on whether
+// to swap values that compare equal without being identical.
+#ifdef __AVX512F__
+// The zero-masking forms with every lane selected stand in for the plain
+// ones, which make GCC 12 warn about their undefined pass-through operand.
+struct network_i32 : true_type {
+  typedef int value_type;
+  typedef __m512i vec;
+  static const int lanes = 16;
+  static value_type pad() { return std::numeric_limits<int>::max(); }
+  static vec load(const void *p) { return _mm512_loadu_si512(p); }
+  static void store(void *p, vec v) { _mm512_storeu_si512(p, v); }
+  static vec load_tail(const void *p, int t) {
+    return _mm512_mask_loadu_epi32(_mm512_set1_epi32(pad()),
+                                   __mmask16((1u << t) - 1), p);
+  }
+  static void sort2(vec &a, vec &b) {
+    vec t = _mm512_maskz_min_epi32(__mmask16(-1), a, b);
+    b = _mm512_maskz_max_epi32(__mmask16(-1), a, b);
+    a = t;
+  }
+  template <int X> static vec exchange(vec v) {
+    if (X < 4)
+      return _mm512_maskz_shuffle_epi32(
+          __mmask16(-1), v, _MM_PERM_ENUM(lane_shuffle<X>::value));
+    return _mm512_maskz_permutexvar_epi32(
+        __mmask16(-1),
+        _mm512_setr_epi32(0 ^ X, 1 ^ X, 2 ^ X, 3 ^ X, 4 ^ X, 5 ^ X, 6 ^ X,
+                          7 ^ X, 8 ^ X, 9 ^ X, 10 ^ X, 11 ^ X, 12 ^ X, 13 ^ X,
+                          14 ^ X, 15 ^ X),
+        v);
+  }
+  template <int X, int Bit> static vec pair(vec v) {
+    vec lo = v, hi = exchange<X>(v);
+    sort2(lo, hi);
+    return _mm512_mask_blend_epi32(__mmask16(lane_mask<Bit, lanes>::value),
+                                   lo, hi);
+  }
+};
+
+struct network_i64 : true_type {
+  typedef long long value_type;
+  typedef __m512i vec;
+  static const int lanes = 8;
+  static value_type pad() { return std::numeric_limits<long long>::max(); }
+  static vec load(const void *p) { return _mm512_loadu_si512(p); }
+  static void store(void *p, vec v) { _mm512_storeu_si512(p, v); }
+  static vec load_tail(const void *p, int t) {
+    return _mm512_mask_loadu_epi64(_mm512_set1_epi64(pad()),
+                                   __mmask8((1u << t) - 1), p);
+  }
+  static void sort2(vec &a, vec &b) {
+    vec t = _mm512_maskz_min_epi64(__mmask8(-1), a, b);
+    b = _mm512_maskz_max_epi64(__mmask8(-1), a, b);
+    a = t;
+  }
+  template <int X> static vec exchange(vec v) {
+    if (X < 4)
+      return _mm512_maskz_permutex_epi64(__mmask8(-1), v,
+                                         lane_shuffle<X>::value);
+    return _mm512_maskz_permutexvar_epi64(
+        __mmask8(-1),
+        _mm512_setr_epi64(0 ^ X, 1 ^ X, 2 ^ X, 3 ^ X, 4 ^ X, 5 ^ X, 6 ^ X,
+                          7 ^ X),
+        v);
+  }
+  template <int X, int Bit> static vec pair(vec v) {
+    vec lo = v, hi = exchange<X>(v);
+    sort2(lo, hi);
+    return _mm512_mask_blend_epi64(__mmask8(lane_mask<Bit, lanes>::value), lo,
+                                   hi);
+  }
+};
+
+struct network_f32 : true_type {
+  typedef float value_type;
+  typedef __m512 vec;
+  static const int lanes = 16;
+  static value_type pad() { return std::numeric_limits<float>::infinity(); }
+  static vec load(const void *p) { return _mm512_loadu_ps(p); }
+  static void store(void *p, vec v) { _mm512_storeu_ps(p, v); }
+  static vec load_tail(const void *p, int t) {
+    return _mm512_mask_loadu_ps(_mm512_set1_ps(pad()),
+                                __mmask16((1u << t) - 1), p);
+  }
+  static void sort2(vec &a, vec &b) {
+    __mmask16 m = _mm512_cmp_ps_mask(b, a, _CMP_LT_OQ);
+    vec t = _mm512_mask_blend_ps(m, a, b);
+    b = _mm512_mask_blend_ps(m, b, a);
+    a = t;
+  }
+  template <int X> static vec exchange(vec v) {
+    if (X < 4)
+      return _mm512_maskz_permute_ps(__mmask16(-1), v, lane_shuffle<X>::value);
+    return _mm512_maskz_permutexvar_ps(
+        __mmask16(-1),
+        _mm512_setr_epi32(0 ^ X, 1 ^ X, 2 ^ X, 3 ^ X, 4 ^ X, 5 ^ X, 6 ^ X,
+                          7 ^ X, 8 ^ X, 9 ^ X, 10 ^ X, 11 ^ X, 12 ^ X, 13 ^ X,
+                          14 ^ X, 15 ^ X),
+        v);
+  }
+  template <int X, int Bit> static vec pair(vec v) {
+    const __mmask16 upper = __mmask16(lane_mask<Bit, lanes>::value);
+    vec p = exchange<X>(v);
+    __mmask16 m = (_mm512_cmp_ps_mask(p, v, _CMP_LT_OQ) & ~upper) |
+                  (_mm512_cmp_ps_mask(v, p, _CMP_LT_OQ) & upper);
+    return _mm512_mask_blend_ps(m, v, p);
+  }
+};
+
+struct network_f64 : true_type {
+  typedef double value_type;
+  typedef __m512d vec;
+  static const int lanes = 8;
+  static value_type pad() { return std::numeric_limits<double>::infinity(); }
+  static vec load(const void *p) { return _mm512_loadu_pd(p); }
+  static void store(void *p, vec v) { _mm512_storeu_pd(p, v); }
+  static vec load_tail(const void *p, int t) {
+    return _mm512_mask_loadu_pd(_mm512_set1_pd(pad()),
+                                __mmask8((1u << t) - 1), p);
+  }
+  static void sort2(vec &a, vec &b) {
+    __mmask8 m = _mm512_cmp_pd_mask(b, a, _CMP_LT_OQ);
+    vec t = _mm512_mask_blend_pd(m, a, b);
+    b = _mm512_mask_blend_pd(m, b, a);
+    a = t;
+  }
+  template <int X> static vec exchange(vec v) {
+    if (X < 4)
+      return _mm512_maskz_permutex_pd(__mmask8(-1), v, lane_shuffle<X>::value);
+    return _mm512_maskz_permutexvar_pd(
+        __mmask8(-1),
+        _mm512_setr_epi64(0 ^ X, 1 ^ X, 2 ^ X, 3 ^ X, 4 ^ X, 5 ^ X, 6 ^ X,
+                          7 ^ X),
+        v);
+  }
+  template <int X, int Bit> static vec pair(vec v) {
+    const __mmask8 upper = __mmask8(lane_mask<Bit, lanes>::value);
+    vec p = exchange<X>(v);
+    __mmask8 m = (_mm512_cmp_pd_mask(p, v, _CMP_LT_OQ) & ~upper) |
+                 (_mm512_cmp_pd_mask(v, p, _CMP_LT_OQ) & upper);
+    return _mm512_mask_blend_pd(m, v, p);
+  }
+};
+#else
+/*! Mask of the first t lanes of 32 or 64 bits, for the masked loads */
+inline __m256i network_first32(int t) {
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32(t),
+                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+inline __m256i network_first64(int t) {
+  return _mm256_cmpgt_epi64(_mm256_set1_epi64x(t),
+                            _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+struct network_i32 : true_type {
+  typedef int value_type;
+  typedef __m256i vec;
+  static const int lanes = 8;
+  static value_type pad() { return std::numeric_limits<int>::max(); }
+  static vec load(const void *p) { return simd_load(p); }
+  static void store(void *p, vec v) { simd_store(p, v); }
+  static vec load_tail(const void *p, int t) {
+    vec m = network_first32(t);
+    return _mm256_blendv_epi8(
+        _mm256_set1_epi32(pad()),
+        _mm256_maskload_epi32(static_cast<const int *>(p), m), m);
+  }
+  static void sort2(vec &a, vec &b) {
+    vec t = _mm256_min_epi32(a, b);
+    b = _mm256_max_epi32(a, b);
+    a = t;
+  }
+  template <int X> static vec exchange(vec v) {
+    if (X < 4)
+      return _mm256_shuffle_epi32(v, lane_shuffle<X>::value);
+    return _mm256_permutevar8x32_epi32(
+        v, _mm256_setr_epi32(0 ^ X, 1 ^ X, 2 ^ X, 3 ^ X, 4 ^ X, 5 ^ X, 6 ^ X,
+                             7 ^ X));
+  }
+  template <int X, int Bit> static vec pair(vec v) {
+    vec lo = v, hi = exchange<X>(v);
+    sort2(lo, hi);
+    return _mm256_blend_epi32(lo, hi, lane_mask<Bit, lanes>::value);
+  }
+};
+
+struct network_i64 : true_type {
+  typedef long long value_type;
+  typedef __m256i vec;
+  static const int lanes = 4;
+  static value_type pad() { return std::numeric_limits<long long>::max(); }
+  static vec load(const void *p) { return simd_load(p); }
+  static void store(void *p, vec v) { simd_store(p, v); }
+  static vec load_tail(const void *p, int t) {
+    vec m = network_first64(t);
+    return _mm256_blendv_epi8(
+        _mm256_set1_epi64x(pad()),
+        _mm256_maskload_epi64(static_cast<const long long *>(p), m), m);
+  }
+  static void sort2(vec &a, vec &b) {
+    vec m = _mm256_cmpgt_epi64(a, b);
+    vec t = _mm256_blendv_epi8(a, b, m);
+    b = _mm256_blendv_epi8(b, a, m);
+    a = t;
+  }
+  template <int X> static vec exchange(vec v) {
+    return _mm256_permute4x64_epi64(v, lane_shuffle<X>::value);
+  }
+  template <int X, int Bit> static vec pair(vec v) {
+    vec lo = v, hi = exchange<X>(v);
+    sort2(lo, hi);
+    return _mm256_blend_epi32(lo, hi, lane_mask<2 * Bit, 2 * lanes>::value);
+  }
+};
+
+struct network_f32 : true_type {
+  typedef float value_type;
+  typedef __m256 vec;
+  static const int lanes = 8;
+  static value_type pad() { return std::numeric_limits<float>::infinity(); }
+  static vec load(const void *p) {
+    return _mm256_loadu_ps(static_cast<const float *>(p));
+  }
+  static void store(void *p, vec v) {
+    _mm256_storeu_ps(static_cast<float *>(p), v);
+  }
+  static vec load_tail(const void *p, int t) {
+    __m256i m = network_first32(t);
+    return _mm256_blendv_ps(
+        _mm256_set1_ps(pad()),
+        _mm256_maskload_ps(static_cast<const float *>(p), m),
+        _mm256_castsi256_ps(m));
+  }
+  static void sort2(vec &a, vec &b) {
+    vec m = _mm256_cmp_ps(b, a, _CMP_LT_OQ);
+    vec t = _mm256_blendv_ps(a, b, m);
+    b = _mm256_blendv_ps(b, a, m);
+    a = t;
+  }
+  template <int X> static vec exchange(vec v) {
+    if (X < 4)
+      return _mm256_permute_ps(v, lane_shuffle<X>::value);
+    return _mm256_permutevar8x32_ps(
+        v, _mm256_setr_epi32(0 ^ X, 1 ^ X, 2 ^ X, 3 ^ X, 4 ^ X, 5 ^ X, 6 ^ X,
+                             7 ^ X));
+  }
+  template <int X, int Bit> static vec pair(vec v) {
+    vec p = exchange<X>(v);
+    vec m = _mm256_blend_ps(_mm256_cmp_ps(p, v, _CMP_LT_OQ),
+                            _mm256_cmp_ps(v, p, _CMP_LT_OQ),
+                            lane_mask<Bit, lanes>::value);
+    return _mm256_blendv_ps(v, p, m);
+  }
+};
+
+struct network_f64 : true_type {
+  typedef double value_type;
+  typedef __m256d vec;
+  static const int lanes = 4;
+  static value_type pad() { return std::numeric_limits<double>::infinity(); }
+  static vec load(const void *p) {
+    return _mm256_loadu_pd(static_cast<const double *>(p));
+  }
+  static void store(void *p, vec v) {
+    _mm256_storeu_pd(static_cast<double *>(p), v);
+  }
+  static vec load_tail(const void *p, int t) {
+    __m256i m = network_first64(t);
+    return _mm256_blendv_pd(
+        _mm256_set1_pd(pad()),
+        _mm256_maskload_pd(static_cast<const double *>(p), m),
+        _mm256_castsi256_pd(m));
+  }
+  static void sort2(vec &a, vec &b) {
+    vec m = _mm256_cmp_pd(b, a, _CMP_LT_OQ);
+    vec t = _mm256_blendv_pd(a, b, m);
+    b = _mm256_blendv_pd(b, a, m);
+    a = t;
+  }
+  template <int X> static vec exchange(vec v) {
+    return _mm256_permute4x64_pd(v, lane_shuffle<X>::value);
+  }
+  template <int X, int Bit> static vec pair(vec v) {
+    vec p = exchange<X>(v);
+    vec m = _mm256_blend_pd(_mm256_cmp_pd(p, v, _CMP_LT_OQ),
+                            _mm256_cmp_pd(v, p, _CMP_LT_OQ),
+                            lane_mask<Bit, lanes>::value);
+    return _mm256_blendv_pd(v, p, m);
+  }
+};
+#endif
+
+template <std::size_t Size> struct network_signed : false_type {};
+template <> struct network_signed<4> : network_i32 {};
+template <> struct network_signed<8> : network_i64 {};
+
+template <> struct sort_network<int> : network_signed<sizeof(int)> {};
+template <> struct sort_network<long> : network_signed<sizeof(long)> {};
+template <>
+struct sort_network<long long> : network_signed<sizeof(long long)> {};
+template <> struct sort_network<float> : network_f32 {};
+template <> struct sort_network<double> : network_f64 {};
+#endif
+
+/*!
+ * True when slices of RandomIt compared with Compare can be sorted by the
+ * networks: contiguous elements of a type with a network, compared with
+ * operator<
+ */
+template <class RandomIt, class Compare,
+          bool Contiguous = contiguous<RandomIt>::value>
+struct sort_network_for : false_type {};
+template <class RandomIt, class Compare>
+struct sort_network_for<RandomIt, Compare, true>
+    : bool_type<is_same<Compare, less>::value &&
+                sort_network<
+                    typename contiguous<RandomIt>::value_type>::value> {};
+
+/*!
+ * Half cleaners of distances J, J/2, ..., 1 between the lanes of a register
+ */
+template <class K, int J> struct network_clean {
+  static typename K::vec run(typename K::vec v) {
+    return network_clean<K, J / 2>::run(K::template pair<J, J>(v));
+  }
+};
+template <class K> struct network_clean<K, 0> {
+  static typename K::vec run(typename K::vec v) { return v; }
+};
+
+/*!
+ * Sorts the first M lanes of a register, and every other group of M, by
+ * bitonic merges of sorted groups of M/2: each lane is compared with its
+ * mirror image in the group, leaving two bitonic halves that the half
+ * cleaners then sort.
+ */
+template <class K, int M> struct network_lanes {
+  static typename K::vec run(typename K::vec v) {
+    v = network_lanes<K, M / 2>::run(v);
+    v = K::template pair<M - 1, M / 2>(v);
+    return network_clean<K, M / 4>::run(v);
+  }
+};
+template <class K> struct network_lanes<K, 1> {
+  static typename K::vec run(typename K::vec v) { return v; }
+};
+
+/*!
+ * Bitonic sort of m registers r, a power of two, in lane order: registers are
+ * sorted on their own, then blocks of sorted registers merged pairwise. Across
+ * registers, the mirror step compares a register with the lane reversal of its
+ * mirror image, and the half cleaners compare whole registers until they get
+ * down to the lanes of a single one.
+ */
+template <class K> void network_sort(typename K::vec *r, std::ptrdiff_t m) {
+  typedef typename K::vec V;
+  const int w = K::lanes;
+  for (std::ptrdiff_t i = 0; i < m; ++i)
+    r[i] = network_lanes<K, w>::run(r[i]);
+  for (std::ptrdiff_t k = 2; k <= m; k *= 2) {
+    for (std::ptrdiff_t i = 0; i < m; i += k)
+      for (std::ptrdiff_t j = 0; j < k / 2; ++j) {
+        V hi = K::template exchange<w - 1>(r[i + k - 1 - j]);
+        K::sort2(r[i + j], hi);
+        r[i + k - 1 - j] = K::template exchange<w - 1>(hi);
+      }
+    for (std::ptrdiff_t d = k / 4; d > 0; d /= 2)
+      for (std::ptrdiff_t i = 0; i < m; i += 2 * d)
+        for (std::ptrdiff_t j = i; j < i + d; ++j)
+          K::sort2(r[j], r[j + d]);
+    for (std::ptrdiff_t i = 0; i < m; ++i)
+      r[i] = network_clean<K, w / 2>::run(r[i]);
+  }
+}
+
+/*!
+ * Sorts the n elements at p, at most sort_network_max, through the network of
+ * the fewest registers that hold them. Lanes past the end load as the largest
+ * value of the type, which sorts after every element. The last register goes
+ * back through a buffer rather than a masked store, which would stall a
+ * following load of the next block, as sorting many short arrays does.
+ */
+template <class K, class T> void network_sort(T *p, std::ptrdiff_t n) {
+  const int w = K::lanes;
+  typename K::vec r[sort_network_max / w];
+  std::ptrdiff_t full = n / w, m = 1;
+  int t = int(n - full * w);
+  while (m * w < n)
+    m *= 2;
+  for (std::ptrdiff_t i = 0; i < full; ++i)
+    r[i] = K::load(p + i * w);
+  for (std::ptrdiff_t i = full; i < m; ++i)
+    r[i] = K::load_tail(p + full * w, i == full ? t : 0);
+  detail::network_sort<K>(r, m);
+  for (std::ptrdiff_t i = 0; i < full; ++i)
+    K::store(p + i * w, r[i]);
+  if (t > 0) {
+    T tail[w];
+    K::store(tail, r[full]);
+    algs::copy(tail, tail + t, p + full * w);
+  }
+}
+
+/*!
+ * Sorts a slice of the quicksort: with a sorting network when the elements
+ * have one, and by insertion sort otherwise
+ */
+template <class RandomIt, class Compare>
+void sort_small(RandomIt b, RandomIt e, Compare &c, bool unguarded,
+                false_type) {
+  detail::insertion_sort(b, e, c, unguarded);
+}
+
+template <class RandomIt, class Compare>
+void sort_small(RandomIt b, RandomIt e, Compare &, bool, true_type) {
+  typedef typename contiguous<RandomIt>::value_type T;
+  if (e - b > 1)
+    detail::network_sort<sort_network<T> >(contiguous<RandomIt>::ptr(b),
+                                           e - b);
+}
+
+template <class RandomIt, class Compare>
+void sort2(RandomIt x, RandomIt y, Compare &c) {
+  if (c(*y, *x))
+    algs::swap(*x, *y);
+}
+
+template <class RandomIt, class Compare>
+void sort3(RandomIt x, RandomIt y, RandomIt z, Compare &c) {
+  detail::sort2(x, y, c);
+  detail::sort2(y, z, c);
+  detail::sort2(x, y, c);
+}
+
+/*!
+ * Restores the heap property of the heap [b,b+n) rooted at i, whose children
+ * are already heaps, by moving value x down from position i
+ */
+template <class RandomIt, class T, class Compare>
+void sift_down(RandomIt b, std::ptrdiff_t n, std::ptrdiff_t i, const T &x,
+               Compare &c) {
+  std::ptrdiff_t child;
+  while ((child = 2 * i + 1) < n) {
+    if (child + 1 < n && c(b[child], b[child + 1]))
+      ++child;
+    if (!c(x, b[child]))
+      break;
+    b[i] = b[child];
+    i = child;
+  }
+  b[i] = x;
+}
+
+/*!
+ * Arranges [b,e) into a heap with its greatest element at b
+ */
+template <class RandomIt, class Compare>
+void make_heap(RandomIt b, RandomIt e, Compare &c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  std::ptrdiff_t n = e - b;
+  for (std::ptrdiff_t i = n / 2; i-- > 0;) {
+    T t = b[i];
+    detail::sift_down(b, n, i, t, c);
+  }
+}
+
+/*!
+ * Sorts the heap [b,e) by repeatedly moving its top to the end
+ */
+template <class RandomIt, class Compare>
+void sort_heap(RandomIt b, RandomIt e, Compare &c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  std::ptrdiff_t n = e - b;
+  while (n > 1) {
+    T t = b[--n];
+    b[n] = b[0];
+    detail::sift_down(b, n, 0, t, c);
+  }
+}
+
+template <class RandomIt, class Compare>
+void heap_sort(RandomIt b, RandomIt e, Compare &c) {
+  detail::make_heap(b, e, c);
+  detail::sort_heap(b, e, c);
+}
+
+/*!
+ * Unary predicate testing whether an element orders before a pivot
+ */
+template <class T, class Compare> struct less_than_pivot {
+  const T *pivot;
+  Compare c;
+
+  bool operator()(const T &x) { return c(x, *pivot); }
+};
+
+/*!
+ * Partitions [b,e) around the pivot *b into elements less than the pivot and
+ * elements not less than it, and moves the pivot between them. The first
+ * misplaced pair is searched for from both ends; when none is found the range
+ * was already partitioned, otherwise the rest is handed to the block
+ * partition.
+ *
+ * @returns the position of the pivot, and whether no element had to be moved
+ */
+template <class RandomIt, class Compare>
+std::pair<RandomIt, bool> partition_right(RandomIt b, RandomIt e,
+                                          Compare &c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  T pivot = *b;
+  RandomIt first = b, last = e;
+  // the median selection guarantees an element not less than the pivot
+  while (c(*++first, pivot))
+    ;
+  if (first - 1 == b)
+    while (first < last && !c(*--last, pivot))
+      ;
+  else
+    while (!c(*--last, pivot))
+      ;
+  bool already_partitioned = first >= last;
+  if (!already_partitioned) {
+    algs::swap(*first, *last);
+    less_than_pivot<T, Compare> p = {&pivot, c};
+    first = algs::partition(first + 1, last, p);
+  }
+  RandomIt pos = first - 1;
+  *b = *pos;
+  *pos = pivot;
+  return std::make_pair(pos, already_partitioned);
+}
+
+/*!
+ * Partitions [b,e) around the pivot *b into elements not greater than the
+ * pivot and elements greater than it. Used when the pivot equals the element
+ * preceding the range, so the left side holds only elements equal to it.
+ *
+ * @returns the position of the pivot
+ */
+template <class RandomIt, class Compare>
+RandomIt partition_left(RandomIt b, RandomIt e, Compare &c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  T pivot = *b;
+  RandomIt first = b, last = e;
+  while (c(pivot, *--last))
+    ;
+  if (last + 1 == e)
+    while (first < last && !c(pivot, *++first))
+      ;
+  else
+    while (!c(pivot, *++first))
+      ;
+  while (first < last) {
+    algs::swap(*first, *last);
+    while (c(pivot, *--last))
+      ;
+    while (!c(pivot, *++first))
+      ;
+  }
+  *b = *last;
+  *last = pivot;
+  return last;
+}
+
+/*!
+ * Swaps a few elements of a badly partitioned side of length n to break up
+ * the pattern that caused it
+ */
+template <class RandomIt>
+void break_pattern(RandomIt b, RandomIt e, std::ptrdiff_t n) {
+  if (n < insertion_sort_threshold)
+    return;
+  algs::swap(b[0], b[n / 4]);
+  algs::swap(e[-1], e[-n / 4]);
+  if (n > ninther_threshold) {
+    algs::swap(b[1], b[n / 4 + 1]);
+    algs::swap(b[2], b[n / 4 + 2]);
+    algs::swap(e[-2], e[-(n / 4 + 1)]);
+    algs::swap(e[-3], e[-(n / 4 + 2)]);
+  }
+}
+
+/*!
+ * Pattern-defeating quicksort of [b,e). Sorts the left side recursively and
+ * loops on the right side; leftmost is false when an element not greater than
+ * any element of the range precedes b. After bad_allowed highly unbalanced
+ * partitions the range is heap sorted to guarantee O(n log n).
+ */
+template <class RandomIt, class Compare>
+void pdqsort(RandomIt b, RandomIt e, Compare &c, int bad_allowed,
+             bool leftmost) {
+  typedef bool_type<sort_network_for<RandomIt, Compare>::value> network;
+  const std::ptrdiff_t threshold =
+      network::value ? sort_network_threshold : insertion_sort_threshold;
+  while (true) {
+    std::ptrdiff_t n = e - b;
+    if (n < threshold) {
+      detail::sort_small(b, e, c, !leftmost, network());
+      return;
+    }
+
+    // median of three, or pseudomedian of nine for larger ranges, to *b
+    std::ptrdiff_t h = n / 2;
+    if (n > ninther_threshold) {
+      detail::sort3(b, b + h, e - 1, c);
+      detail::sort3(b + 1, b + (h - 1), e - 2, c);
+      detail::sort3(b + 2, b + (h + 1), e - 3, c);
+      detail::sort3(b + (h - 1), b + h, b + (h + 1), c);
+      algs::swap(*b, b[h]);
+    } else
+      detail::sort3(b + h, b, e - 1, c);
+
+    // a pivot equal to the preceding element is the smallest value in the
+    // range, so its equal elements are set aside without further sorting
+    if (!leftmost && !c(b[-1], *b)) {
+      b = detail::partition_left(b, e, c) + 1;
+      continue;
+    }
+
+    std::pair<RandomIt, bool> part = detail::partition_right(b, e, c);
+    RandomIt pos = part.first;
+    std::ptrdiff_t l = pos - b, r = e - (pos + 1);
+    if (l < n / 8 || r < n / 8) {
+      if (--bad_allowed == 0) {
+        detail::heap_sort(b, e, c);
+        return;
+      }
+      detail::break_pattern(b, pos, l);
+      detail::break_pattern(pos + 1, e, r);
+    } else if (part.second && detail::partial_insertion_sort(b, pos, c) &&
+               detail::partial_insertion_sort(pos + 1, e, c))
+      return;
+
+    detail::pdqsort(b, pos, c, bad_allowed, leftmost);
+    b = pos + 1;
+    leftmost = false;
+  }
+}
+
+} /* namespace detail */
+
+/*!
+ * Sorts the sequence [b,e) with a pattern-defeating quicksort: insertion sort
+ * for short slices, median of three or pseudomedian of nine pivots, block
+ * partitioning, linear time on ascending, descending and partially sorted
+ * patterns, and a heap sort fallback guaranteeing O(n log n) comparisons. The
+ * sort is not stable.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param c comparator function
+ */
+template <class RandomIt, class Compare>
+void sort(RandomIt b, RandomIt e, Compare c) {
+  std::ptrdiff_t n = e - b;
+  if (n < 2)
+    return;
+  // whole range ascending or descending: nothing to do, or a reversal
+  RandomIt it = b + 1;
+  if (c(*it, *b)) {
+    while (++it != e && !c(it[-1], *it))
+      ;
+    if (it == e) {
+      algs::reverse(b, e);
+      return;
+    }
+  } else {
+    while (++it != e && !c(*it, it[-1]))
+      ;
+    if (it == e)
+      return;
+  }
+  int bad_allowed = 0;
+  while (n > 1) {
+    n >>= 1;
+    ++bad_allowed;
+  }
+  detail::pdqsort(b, e, c, bad_allowed, true);
+}
+
+/*!
+ * Sorts the sequence [b,e) in ascending order using operator<
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ */
+template <class RandomIt> void sort(RandomIt b, RandomIt e) {
+  algs::sort(b, e, detail::less());
+}
+
+/*!
+ * Sorts a short sequence [b,e), for callers sorting many small arrays.
+ * Contiguous ranges of up to 256 ints, longs, long longs, floats or doubles
+ * compared with operator< are sorted with one bitonic sorting network in AVX2
+ * or AVX-512 registers when the target has them, without the passes over the
+ * range that sort makes to look for patterns; floating point ranges must not
+ * hold NaN. Other ranges are sorted by sort. The sort is not stable.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param c comparator function
+ */
+template <class RandomIt, class Compare>
+void sort_small(RandomIt b, RandomIt e, Compare c) {
+  typedef detail::bool_type<
+      detail::sort_network_for<RandomIt, Compare>::value>
+      network;
+  if (network::value && e - b <= detail::sort_network_max)
+    detail::sort_small(b, e, c, false, network());
+  else
+    algs::sort(b, e, c);
+}
+
+/*!
+ * Sorts a short sequence [b,e) in ascending order using operator<
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ */
+template <class RandomIt> void sort_small(RandomIt b, RandomIt e) {
+  algs::sort_small(b, e, detail::less());
+}
+
+namespace detail {
+
+/*!
+ * Sample elements drawn per bucket by the parallel sort, to place the
+ * splitters close to the quantiles they estimate
+ */
+const std::ptrdiff_t sample_sort_oversampling = 16;
+
+/*!
+ * Splitters of the parallel sort in a classification tree: stored in
+ * Eytzinger order, so that an element finds its leaf by a descent of fixed
+ * length that computes each step from a comparison instead of branching on
+ * it. Leaf j receives the elements after the first j splitters and not after
+ * upper[j]. It feeds bucket 2j, or, when equal is set and j is below the
+ * splitter count, the elements equal to upper[j] go to equality bucket 2j+1.
+ */
+template <class T, class Compare> struct sample_tree {
+  const T *tree, *upper;
+  int levels;
+  std::ptrdiff_t splitters;
+  bool equal;
+  Compare c;
+
+  template <class X> std::ptrdiff_t operator()(const X &x) {
+    std::ptrdiff_t i = 1;
+    for (int l = 0; l < levels; ++l)
+      i = 2 * i + c(tree[i], x);
+    i -= std::ptrdiff_t(1) << levels;
+    return 2 * i + (equal && ((i < splitters) & !c(x, upper[i])));
+  }
+};
+
+/*!
+ * Builds the classification tree of the sorted splitters s, returning the
+ * number of splitters placed
+ */
+template <class T>
+std::ptrdiff_t sample_build(const std::vector<T> &s, std::vector<T> &tree,
+                            std::ptrdiff_t i, std::ptrdiff_t k) {
+  if (k < std::ptrdiff_t(tree.size())) {
+    i = sample_build(s, tree, i, 2 * k);
+    tree[k] = s[i++];
+    i = sample_build(s, tree, i, 2 * k + 1);
+  }
+  return i;
+}
+
+/*!
+ * Parallel task checking whether chunk i, and its boundary with the next
+ * chunk, is in ascending order
+ */
+template <class RandomIt, class Compare> struct sample_sorted {
+  RandomIt b;
+  std::ptrdiff_t n, k;
+  Compare c;
+  char *sorted;
+
+  void operator()(std::ptrdiff_t i) const {
+    Compare f = c;
+    std::ptrdiff_t last = chunk_begin(n, k, i + 1);
+    RandomIt it = b + chunk_begin(n, k, i), ce = b + (last < n ? last + 1 : n);
+    while (++it != ce && !f(*it, it[-1]))
+      ;
+    sorted[i] = it == ce;
+  }
+};
+
+/*!
+ * Parallel task counting the elements of chunk i in every bucket, or, once
+ * offsets are known, copy constructing them into their bucket in the buffer
+ */
+template <class RandomIt, class T, class Compare> struct sample_distribute {
+  RandomIt b;
+  std::ptrdiff_t n, k, buckets;
+  sample_tree<T, Compare> classify;
+  std::ptrdiff_t *count;
+  T *buf;
+
+  void operator()(std::ptrdiff_t i) const {
+    sample_tree<T, Compare> f = classify;
+    std::ptrdiff_t *c = count + i * buckets;
+    RandomIt ce = b + chunk_begin(n, k, i + 1);
+    if (!buf) {
+      for (std::ptrdiff_t j = 0; j < buckets; ++j)
+        c[j] = 0;
+      for (RandomIt it = b + chunk_begin(n, k, i); it != ce; ++it)
+        ++c[f(*it)];
+    } else
+      for (RandomIt it = b + chunk_begin(n, k, i); it != ce; ++it)
+        ::new (static_cast<void *>(buf + c[f(*it)]++)) T(*it);
+  }
+};
+
+/*!
+ * Parallel task copying chunk i of the distributed elements back from the
+ * buffer to the range
+ */
+template <class RandomIt, class T> struct sample_copy {
+  const T *buf;
+  RandomIt b;
+  std::ptrdiff_t n, k;
+
+  void operator()(std::ptrdiff_t i) const {
+    std::ptrdiff_t f = chunk_begin(n, k, i);
+    algs::copy(buf + f, buf + chunk_begin(n, k, i + 1), b + f);
+  }
+};
+
+/*!
+ * Parallel task sorting bucket 2j in place; the equality buckets between
+ * them hold copies of a single key and need no sorting
+ */
+template <class RandomIt, class Compare> struct sample_bucket {
+  RandomIt b;
+  const std::ptrdiff_t *start;
+  Compare c;
+
+  void operator()(std::ptrdiff_t j) const {
+    algs::sort(b + start[2 * j], b + start[2 * j + 1], c);
+  }
+};
+
+} /* namespace detail */
+
+/*!
+ * Parallel version of sort: a sample sort. Ranges already in ascending
+ * order, found by a parallel scan, are left as they are. Otherwise splitters
+ * picked from a sorted random sample divide the values into a few buckets per
+ * thread; the sample is oversampled to balance the buckets. Every thread
+ * classifies its chunk of the range through a branch-free tree of the
+ * splitters twice. The first pass counts the elements of each bucket, and
+ * the second copies them to a buffer at offsets that a prefix sum of the
+ * counts reserves for the chunk. A key that fills several quantiles of the
+ * sample appears once among the splitters and gets an equality bucket that
+ * is never sorted, so few distinct keys cost no more than many. The buckets
+ * are copied back in parallel and sorted independently, handed out to the
+ * threads as they become free. Uses a temporary buffer as long as the range,
+ * and sorts serially when it cannot be allocated. The sort is not stable.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param c comparator function
+ */
+template <class RandomIt, class Compare>
+void sort(const parallel_policy &, RandomIt b, RandomIt e, Compare c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  std::ptrdiff_t n = e - b;
+  std::ptrdiff_t k = detail::chunk_count(n);
+  if (k == 1) {
+    algs::sort(b, e, c);
+    return;
+  }
+  std::vector<char> sorted(k);
+  detail::sample_sorted<RandomIt, Compare> check = {b, n, k, c, &sorted[0]};
+  detail::parallel_for(k, check);
+  std::ptrdiff_t ascending = 0;
+  while (ascending < k && sorted[ascending])
+    ++ascending;
+  if (ascending == k)
+    return;
+  detail::temporary_buffer<T> buf(n);
+  if (buf.size() < n) {
+    algs::sort(b, e, c);
+    return;
+  }
+  // four leaves per thread or more, a power of two for the tree
+  int levels = 2;
+  while ((std::ptrdiff_t(1) << levels) < 4 * k)
+    ++levels;
+  std::ptrdiff_t leaves = std::ptrdiff_t(1) << levels;
+
+  // one sample drawn at random from each of m equal strides of the range
+  std::vector<T> sample;
+  std::ptrdiff_t m = leaves * detail::sample_sort_oversampling;
+  std::ptrdiff_t stride = n / m;
+  unsigned int r = 2463534242u;
+  for (std::ptrdiff_t i = 0; i < m; ++i) {
+    r ^= r << 13;
+    r ^= r >> 17;
+    r ^= r << 5;
+    sample.push_back(b[i * stride + std::ptrdiff_t(r) % stride]);
+  }
+  algs::sort(sample.begin(), sample.end(), c);
+  // the sample quantiles, each distinct one kept once, padded to a leaf
+  // count for a tree only as deep as they need
+  std::vector<T> upper(1, sample[detail::sample_sort_oversampling]);
+  bool equal = false;
+  for (std::ptrdiff_t j = 2; j < leaves; ++j) {
+    const T &s = sample[j * detail::sample_sort_oversampling];
+    if (c(upper.back(), s))
+      upper.push_back(s);
+    else
+      equal = true;
+  }
+  std::ptrdiff_t splitters = std::ptrdiff_t(upper.size());
+  for (levels = 1; (std::ptrdiff_t(1) << levels) <= splitters; ++levels)
+    ;
+  leaves = std::ptrdiff_t(1) << levels;
+  upper.resize(leaves, upper.back());
+  std::vector<T> tree(leaves, upper[0]);
+  detail::sample_build(upper, tree, 0, 1);
+
+  std::ptrdiff_t buckets = 2 * leaves;
+  std::vector<std::ptrdiff_t> count(k * buckets), start(buckets + 1);
+  detail::sample_tree<T, Compare> classify = {&tree[0], &upper[0], levels,
+                                              splitters, equal, c};
+  detail::sample_distribute<RandomIt, T, Compare> distribute = {
+      b, n, k, buckets, classify, &count[0], 0};
+  detail::parallel_for(k, distribute);
+  std::ptrdiff_t sum = 0;
+  for (std::ptrdiff_t j = 0; j < buckets; ++j) {
+    start[j] = sum;
+    for (std::ptrdiff_t i = 0; i < k; ++i) {
+      std::ptrdiff_t t = count[i * buckets + j];
+      count[i * buckets + j] = sum;
+      sum += t;
+    }
+  }
+  start[buckets] = n;
+  distribute.buf = buf.data();
+  detail::parallel_for(k, distribute);
+  buf.set_constructed(n);
+  detail::sample_copy<RandomIt, T> back = {buf.data(), b, n, k};
+  detail::parallel_for(k, back);
+  detail::sample_bucket<RandomIt, Compare> finish = {b, &start[0], c};
+  detail::parallel_for_dynamic(leaves, finish);
+}
+
+/*!
+ * Parallel version of sort using operator<
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ */
+template <class RandomIt>
+void sort(const parallel_policy &p, RandomIt b, RandomIt e) {
+  algs::sort(p, b, e, detail::less());
+}
+
+namespace detail {
+
+/*!
+ * Median of medians of groups of five in [b,e). The group medians are
+ * gathered at the front of the range and their median is selected
+ * recursively, which guarantees that at least 30% of the elements lie on
+ * each side of the result.
+ *
+ * @returns an iter to the element chosen as the pivot
+ */
+template <class RandomIt, class Compare>
+RandomIt median_of_medians(RandomIt b, RandomIt e, Compare &c);
+
+/*!
+ * Unbalanced partitions introselect accepts before switching to median of
+ * medians pivots. Each costs a pass over the range that may remove only a few
+ * elements, so a budget growing with n, as in the sort, would allow
+ * O(n log n) work on adversarial inputs.
+ */
+const int select_bad_allowed = 2;
+
+/*!
+ * Introselect: quickselect with the pivots and partitions of the sort above,
+ * switching to median of medians pivots with a three-way partition after
+ * bad_allowed unbalanced partitions, so the worst case stays linear. leftmost
+ * has the same meaning as in pdqsort.
+ */
+template <class RandomIt, class Compare>
+void nth_element(RandomIt b, RandomIt nth, RandomIt e, Compare &c,
+                 int bad_allowed, bool leftmost) {
+  while (e - b >= insertion_sort_threshold) {
+    std::ptrdiff_t n = e - b;
+    if (bad_allowed <= 0) {
+      typedef typename std::iterator_traits<RandomIt>::value_type T;
+      T pivot = *detail::median_of_medians(b, e, c);
+      std::pair<RandomIt, RandomIt> eq =
+          algs::three_way_partition(b, e, pivot, c);
+      if (nth < eq.first)
+        e = eq.first;
+      else if (nth < eq.second)
+        return;
+      else
+        b = eq.second;
+      continue;
+    }
+
+    std::ptrdiff_t h = n / 2;
+    if (n > ninther_threshold) {
+      detail::sort3(b, b + h, e - 1, c);
+      detail::sort3(b + 1, b + (h - 1), e - 2, c);
+      detail::sort3(b + 2, b + (h + 1), e - 3, c);
+      detail::sort3(b + (h - 1), b + h, b + (h + 1), c);
+      algs::swap(*b, b[h]);
+    } else
+      detail::sort3(b + h, b, e - 1, c);
+
+    RandomIt pos;
+    if (!leftmost && !c(b[-1], *b)) {
+      // [b,pos] all equal the smallest value of the range
+      pos = detail::partition_left(b, e, c);
+      if (nth <= pos)
+        return;
+      if (pos - b < n / 8)
+        --bad_allowed;
+      b = pos + 1;
+      continue;
+    }
+    pos = detail::partition_right(b, e, c).first;
+    if (pos - b < n / 8 || e - pos < n / 8)
+      --bad_allowed;
+    if (nth == pos)
+      return;
+    if (nth < pos)
+      e = pos;
+    else {
+      b = pos + 1;
+      leftmost = false;
+    }
+  }
+  detail::insertion_sort(b, e, c, false);
+}
+
+template <class RandomIt, class Compare>
+RandomIt median_of_medians(RandomIt b, RandomIt e, Compare &c) {
+  std::ptrdiff_t n = e - b;
+  if (n <= 5) {
+    detail::insertion_sort(b, e, c, false);
+    return b + n / 2;
+  }
+  RandomIt d = b;
+  for (RandomIt g = b; g != e;) {
+    RandomIt ge = e - g > 5 ? g + 5 : e;
+    detail::insertion_sort(g, ge, c, false);
+    algs::swap(*d++, g[(ge - g) / 2]);
+    g = ge;
+  }
+  RandomIt m = b + (d - b) / 2;
+  detail::nth_element(b, m, d, c, 0, true);
+  return m;
+}
+
+} /* namespace detail */
+
+/*!
+ * Rearranges the sequence [b,e) so that nth holds the element that would be
+ * there if the sequence were sorted, with no element before nth greater than
+ * it and no element after it less than it. Runs in expected linear time, and
+ * in linear time in the worst case thanks to a median of medians fallback.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param nth random access iter marking the element to select
+ * @param e random access iter marking the end of the sequence
+ * @param c comparator function
+ */
+template <class RandomIt, class Compare>
+void nth_element(RandomIt b, RandomIt nth, RandomIt e, Compare c) {
+  if (nth == e)
+    return;
+  detail::nth_element(b, nth, e, c, detail::select_bad_allowed, true);
+}
+
+/*!
+ * Selects the nth smallest element of [b,e) into position nth using
+ * operator<
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param nth random access iter marking the element to select
+ * @param e random access iter marking the end of the sequence
+ */
+template <class RandomIt>
+void nth_element(RandomIt b, RandomIt nth, RandomIt e) {
+  algs::nth_element(b, nth, e, detail::less());
+}
+
+/*!
+ * Places the m - b smallest elements of the sequence [b,e) in sorted order in
+ * [b,m), leaving the rest in unspecified order in [m,e). A bounded heap of the
+ * smallest elements seen is kept in [b,m) while scanning the rest, which takes
+ * O(n log k) time for k = m - b; when k is a sizeable fraction of the range,
+ * selecting with nth_element and sorting the prefix is faster and used
+ * instead.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param m random access iter marking the end of the part to sort
+ * @param e random access iter marking the end of the sequence
+ * @param c comparator function
+ */
+template <class RandomIt, class Compare>
+void partial_sort(RandomIt b, RandomIt m, RandomIt e, Compare c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  std::ptrdiff_t k = m - b;
+  if (k == 0)
+    return;
+  if (k > (e - b) / 16) {
+    algs::nth_element(b, m - 1, e, c);
+    algs::sort(b, m - 1, c);
+    return;
+  }
+  detail::make_heap(b, m, c);
+  for (RandomIt it = m; it != e; ++it) {
+    if (c(*it, *b)) {
+      T t = *it;
+      *it = *b;
+      detail::sift_down(b, k, 0, t, c);
+    }
+  }
+  detail::sort_heap(b, m, c);
+}
+
+/*!
+ * Sorts the m - b smallest elements of [b,e) into [b,m) using operator<
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param m random access iter marking the end of the part to sort
+ * @param e random access iter marking the end of the sequence
+ */
+template <class RandomIt>
+void partial_sort(RandomIt b, RandomIt m, RandomIt e) {
+  algs::partial_sort(b, m, e, detail::less());
+}
+
+/*!
+ * Copies the smallest elements of the sequence [b,e) in sorted order into
+ * [rb,re), as many as fit. The input is read once as a stream while a bounded
+ * heap of the smallest elements seen is kept in the destination.
+ *
+ * @param b input iter marking the beginning of the source sequence
+ * @param e input iter marking the end of the source sequence
+ * @param rb random access iter marking the beginning of the destination
+ * @param re random access iter marking the end of the destination
+ * @param c comparator function
+ *
+ * @returns a random access iter marking the end of the sorted elements
+ */
+template <class InputIt, class RandomIt, class Compare>
+RandomIt partial_sort_copy(InputIt b, InputIt e, RandomIt rb, RandomIt re,
+                           Compare c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  RandomIt r = rb;
+  for (; b != e && r != re; ++b, ++r)
+    *r = *b;
+  std::ptrdiff_t k = r - rb;
+  if (k == 0)
+    return r;
+  detail::make_heap(rb, r, c);
+  for (; b != e; ++b) {
+    if (c(*b, *rb)) {
+      T t = *b;
+      detail::sift_down(rb, k, 0, t, c);
+    }
+  }
+  detail::sort_heap(rb, r, c);
+  return r;
+}
+
+/*!
+ * Copies the smallest elements of [b,e) in sorted order into [rb,re) using
+ * operator<
+ *
+ * @param b input iter marking the beginning of the source sequence
+ * @param e input iter marking the end of the source sequence
+ * @param rb random access iter marking the beginning of the destination
+ * @param re random access iter marking the end of the destination
+ *
+ * @returns a random access iter marking the end of the sorted elements
+ */
+template <class InputIt, class RandomIt>
+RandomIt partial_sort_copy(InputIt b, InputIt e, RandomIt rb, RandomIt re) {
+  return algs::partial_sort_copy(b, e, rb, re, detail::less());
+}
+
+/*!
+ * Gathers the sum of sequence [b,e) into Accumulator a
+ *
+ * @param b iter marking the beginning of the sequence
+ * @param e iter marking the end of the sequence
+ * @param a accumulator holding the sum of the sequence
+ *
+ * @returns the value of same type as the accumulator containing sum of the
+ * sequence plus its initial value
+ */
+template <class InputIt, class Accumulator>
+Accumulator accumulate(InputIt b, InputIt e, Accumulator &a) {
+  while (b != e)
+    a += *b++;
+  return a;
+}
+
+/*!
+ * Applies the function f to each element in the sequence [b,e)
+ *
+ * @param b input iter marking the beginning of the sequence
+ * @param e input iter marking the end of the sequence
+ * @param f function to be apllied to each element
+ *
+ * @returns function f
+ */
+template <class InputIt, class Function>
+Function for_each(InputIt b, InputIt e, Function f) {
+  while (b != e) {
+    f(*b);
+    ++b;
+  }
+  return f;
+}
+
+namespace detail {
+
+/*!
+ * Search core shared by partition_point and the binary searches: halves the
+ * length of the candidate range, so forward iterators need only as many
+ * increments as the range is long
+ */
+template <class ForwardIt, class UnaryPred>
+ForwardIt partition_point(ForwardIt b, ForwardIt e, UnaryPred &p,
+                          std::forward_iterator_tag) {
+  typename std::iterator_traits<ForwardIt>::difference_type n =
+      std::distance(b, e);
+  while (n > 0) {
+    typename std::iterator_traits<ForwardIt>::difference_type h = n / 2;
+    ForwardIt mid = b;
+    std::advance(mid, h);
+    if (p(*mid)) {
+      b = ++mid;
+      n -= h + 1;
+    } else
+      n = h;
+  }
+  return b;
+}
+
+/*!
+ * Branchless search core for random access ranges: every step keeps the upper
+ * or lower half of the candidates with a conditional move instead of a branch
+ * the CPU would mispredict half the time on random queries. Both midpoints the
+ * next step may probe are prefetched, which hides most of the memory latency
+ * once the range no longer fits in cache.
+ */
+template <class RandomIt, class UnaryPred>
+RandomIt partition_point(RandomIt b, RandomIt e, UnaryPred &p,
+                         std::random_access_iterator_tag) {
+  typename std::iterator_traits<RandomIt>::difference_type n = e - b;
+  if (n == 0)
+    return b;
+  while (n > 1) {
+    typename std::iterator_traits<RandomIt>::difference_type h = n / 2;
+    n -= h;
+    prefetch(b + n / 2);
+    prefetch(b + h + n / 2);
+    b = p(b[h]) ? b + h : b;
+  }
+  return b + p(*b);
+}
+
+/*!
+ * Predicate of lower_bound: true for elements ordered before x
+ */
+template <class X, class Compare> struct before {
+  const X *x;
+  Compare c;
+
+  template <class Y> bool operator()(const Y &y) { return c(y, *x); }
+};
+
+/*!
+ * Predicate of upper_bound: true for elements not ordered after x
+ */
+template <class X, class Compare> struct not_after {
+  const X *x;
+  Compare c;
+
+  template <class Y> bool operator()(const Y &y) { return !c(*x, y); }
+};
+
+} /* namespace detail */
+
+/*!
+ * Finds the end of the first partition of the sequence [b,e), which must be
+ * partitioned with respect to predicate p
+ *
+ * @param b forward iter marking the beginning of the sequence
+ * @param e forward iter marking the end of the sequence
+ * @param p unary predicate function
+ *
+ * @returns a forward iter to the first element where p returns false, or e
+ */
+template <class ForwardIt, class UnaryPred>
+ForwardIt partition_point(ForwardIt b, ForwardIt e, UnaryPred p) {
+  return detail::partition_point(
+      b, e, p, typename std::iterator_traits<ForwardIt>::iterator_category());
+}
+
+/*!
+ * Finds the first position in the sorted sequence [b,e) where x could be
+ * inserted without breaking the order
+ *
+ * @param b forward iter marking the beginning of the sequence
+ * @param e forward iter marking the end of the sequence
+ * @param x target value for search
+ * @param c comparator function the sequence is sorted by
+ *
+ * @returns a forward iter to the first element not ordered before x, or e
+ */
+template <class ForwardIt, class X, class Compare>
+ForwardIt lower_bound(ForwardIt b, ForwardIt e, const X &x, Compare c) {
+  detail::before<X, Compare> p = {&x, c};
+  return algs::partition_point(b, e, p);
+}
+
+/*!
+ * Finds the first element not less than x in the sorted sequence [b,e)
+ *
+ * @param b forward iter marking the beginning of the sequence
+ * @param e forward iter marking the end of the sequence
+ * @param x target value for search
+ *
+ * @returns a forward iter to the first element not less than x, or e
+ */
+template <class ForwardIt, class X>
+ForwardIt lower_bound(ForwardIt b, ForwardIt e, const X &x) {
+  return algs::lower_bound(b, e, x, detail::less());
+}
+
+/*!
+ * Finds the last position in the sorted sequence [b,e) where x could be
+ * inserted without breaking the order
+ *
+ * @param b forward iter marking the beginning of the sequence
+ * @param e forward iter marking the end of the sequence
+ * @param x target value for search
+ * @param c comparator function the sequence is sorted by
+ *
+ * @returns a forward iter to the first element ordered after x, or e
+ */
+template <class ForwardIt, class X, class Compare>
+ForwardIt upper_bound(ForwardIt b, ForwardIt e, const X &x, Compare c) {
+  detail::not_after<X, Compare> p = {&x, c};
+  return algs::partition_point(b, e, p);
+}
+
+/*!
+ * Finds the first element greater than x in the sorted sequence [b,e)
+ *
+ * @param b forward iter marking the beginning of the sequence
+ * @param e forward iter marking the end of the sequence
+ * @param x target value for search
+ *
+ * @returns a forward iter to the first element greater than x, or e
+ */
+template <class ForwardIt, class X>
+ForwardIt upper_bound(ForwardIt b, ForwardIt e, const X &x) {
+  return algs::upper_bound(b, e, x, detail::less());
+}
+
+/*!
+ * Finds the subrange of the sorted sequence [b,e) of elements equivalent to x
+ *
+ * @param b forward iter marking the beginning of the sequence
+ * @param e forward iter marking the end of the sequence
+ * @param x target value for search
+ * @param c comparator function the sequence is sorted by
+ *
+ * @returns the pair of lower_bound and upper_bound of x
+ */
+template <class ForwardIt, class X, class Compare>
+std::pair<ForwardIt, ForwardIt> equal_range(ForwardIt b, ForwardIt e,
+                                            const X &x, Compare c) {
+  b = algs::lower_bound(b, e, x, c);
+  return std::make_pair(b, algs::upper_bound(b, e, x, c));
+}
+
+/*!
+ * Finds the subrange of the sorted sequence [b,e) of elements equal to x
+ *
+ * @param b forward iter marking the beginning of the sequence
+ * @param e forward iter marking the end of the sequence
+ * @param x target value for search
+ *
+ * @returns the pair of lower_bound and upper_bound of x
+ */
+template <class ForwardIt, class X>
+std::pair<ForwardIt, ForwardIt> equal_range(ForwardIt b, ForwardIt e,
+                                            const X &x) {
+  return algs::equal_range(b, e, x, detail::less());
+}
+
+/*!
+ * Performs binary search on the sorted sequence [b,e) with lower_bound
+ *
+ * @param b iter marking the beginning of the sequence
+ * @param e iter marking the end of the sequence
+ * @param x target value for search
+ * @param c comparator function the sequence is sorted by
+ *
+ * @returns true if target value was found, otherwise false
+ */
+template <class ForwardIt, class X, class Compare>
+bool binary_search(ForwardIt b, ForwardIt e, const X &x, Compare c) {
+  b = algs::lower_bound(b, e, x, c);
+  return b != e && !c(x, *b);
+}
+
+/*!
+ * Performs simple binary search on sequence [b,e)
+ *
+ * @param b iter marking the beginning of the sequence
+ * @param e iter marking the end of the sequence
+ * @param x target value for search
+ *
+ * @returns true if target value was found, otherwise false
+ */
+template <class ForwardIt, class X>
+bool binary_search(ForwardIt b, ForwardIt e, const X &x) {
+  return algs::binary_search(b, e, x, detail::less());
+}
+
+namespace detail {
+
+/*!
+ * Number of queries the batched searches advance in lock-step, enough to keep
+ * a core's line fill buffers busy with independent cache misses
+ */
+const int search_group = 16;
+
+/*!
+ * Finds the lower bounds in [b,e) of the m values at q[0..m), one level of the
+ * branchless search at a time for all of them. The probes of one level are
+ * independent, and each query prefetches both probes of its next level, so up
+ * to 2m cache misses overlap instead of one. Tables that fit in cache are
+ * searched one query at a time, which is cheaper without the misses.
+ */
+template <class RandomIt, class ForwardIt, class Compare>
+void lower_bound_group(RandomIt b, RandomIt e, const ForwardIt *q, int m,
+                       RandomIt *pos, Compare &c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  typename std::iterator_traits<RandomIt>::difference_type n = e - b;
+  if (n * std::ptrdiff_t(sizeof(T)) <= prefetch_cutoff) {
+    for (int i = 0; i < m; ++i)
+      pos[i] = algs::lower_bound(b, e, *q[i], c);
+    return;
+  }
+  for (int i = 0; i < m; ++i)
+    pos[i] = b;
+  while (n > 1) {
+    typename std::iterator_traits<RandomIt>::difference_type h = n / 2;
+    n -= h;
+    for (int i = 0; i < m; ++i) {
+      RandomIt p = pos[i];
+      prefetch(p + n / 2);
+      prefetch(p + h + n / 2);
+      pos[i] = p + h * c(p[h], *q[i]);
+    }
+  }
+  for (int i = 0; i < m; ++i)
+    pos[i] += c(*pos[i], *q[i]);
+}
+
+} /* namespace detail */
+
+/*!
+ * Finds the lower bound in the sorted sequence [b,e) of every value in
+ * [qb,qe), interleaving the searches so that their cache misses overlap
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param qb forward iter marking the beginning of the queries
+ * @param qe forward iter marking the end of the queries
+ * @param d output iter receiving one random access iter per query
+ * @param c comparator function the sequence is sorted by
+ *
+ * @returns output iter marking the end of the results
+ */
+template <class RandomIt, class ForwardIt, class OutputIt, class Compare>
+OutputIt lower_bound_batch(RandomIt b, RandomIt e, ForwardIt qb, ForwardIt qe,
+                           OutputIt d, Compare c) {
+  ForwardIt q[detail::search_group];
+  RandomIt pos[detail::search_group];
+  while (qb != qe) {
+    int m = 0;
+    for (; m < detail::search_group && qb != qe; ++m, ++qb)
+      q[m] = qb;
+    detail::lower_bound_group(b, e, q, m, pos, c);
+    for (int i = 0; i < m; ++i, ++d)
+      *d = pos[i];
+  }
+  return d;
+}
+
+/*!
+ * Finds the first element not less than each value in [qb,qe) in the sorted
+ * sequence [b,e), interleaving the searches so that their cache misses overlap
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param qb forward iter marking the beginning of the queries
+ * @param qe forward iter marking the end of the queries
+ * @param d output iter receiving one random access iter per query
+ *
+ * @returns output iter marking the end of the results
+ */
+template <class RandomIt, class ForwardIt, class OutputIt>
+OutputIt lower_bound_batch(RandomIt b, RandomIt e, ForwardIt qb, ForwardIt qe,
+                           OutputIt d) {
+  return algs::lower_bound_batch(b, e, qb, qe, d, detail::less());
+}
+
+/*!
+ * Performs binary search on the sorted sequence [b,e) for every value in
+ * [qb,qe), interleaving the searches so that their cache misses overlap
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param qb forward iter marking the beginning of the queries
+ * @param qe forward iter marking the end of the queries
+ * @param d output iter receiving true for each query found, otherwise false
+ * @param c comparator function the sequence is sorted by
+ *
+ * @returns output iter marking the end of the results
+ */
+template <class RandomIt, class ForwardIt, class OutputIt, class Compare>
+OutputIt binary_search_batch(RandomIt b, RandomIt e, ForwardIt qb,
+                             ForwardIt qe, OutputIt d, Compare c) {
+  ForwardIt q[detail::search_group];
+  RandomIt pos[detail::search_group];
+  while (qb != qe) {
+    int m = 0;
+    for (; m < detail::search_group && qb != qe; ++m, ++qb)
+      q[m] = qb;
+    detail::lower_bound_group(b, e, q, m, pos, c);
+    for (int i = 0; i < m; ++i, ++d)
+      *d = pos[i] != e && !c(*q[i], *pos[i]);
+  }
+  return d;
+}
+
+/*!
+ * Performs binary search on the sorted sequence [b,e) for every value in
+ * [qb,qe), interleaving the searches so that their cache misses overlap
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param qb forward iter marking the beginning of the queries
+ * @param qe forward iter marking the end of the queries
+ * @param d output iter receiving true for each query found, otherwise false
+ *
+ * @returns output iter marking the end of the results
+ */
+template <class RandomIt, class ForwardIt, class OutputIt>
+OutputIt binary_search_batch(RandomIt b, RandomIt e, ForwardIt qb,
+                             ForwardIt qe, OutputIt d) {
+  return algs::binary_search_batch(b, e, qb, qe, d, detail::less());
+}
+
+/*!
+ * Finds the first position in the sorted sequence [b,e) where x could be
+ * inserted without breaking the order, searching outwards from hint in steps
+ * that double until x is bracketed and then by binary search. This costs
+ * O(log d) comparisons where d is the distance from hint to the result.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param hint random access iter in [b,e] where the search starts
+ * @param x target value for search
+ * @param c comparator function the sequence is sorted by
+ *
+ * @returns a random access iter to the first element not ordered before x,
+ * or e
+ */
+template <class RandomIt, class X, class Compare>
+RandomIt exponential_lower_bound(RandomIt b, RandomIt e, RandomIt hint,
+                                 const X &x, Compare c) {
+  typename std::iterator_traits<RandomIt>::difference_type step = 1;
+  if (hint == e || !c(*hint, x)) {
+    // The result is in [b,hint]: gallop towards b
+    while (hint - b > step && !c(hint[-step], x)) {
+      hint -= step;
+      step *= 2;
+    }
+    b = hint - b > step ? hint - step + 1 : b;
+    return algs::lower_bound(b, hint, x, c);
+  }
+  // The result is in (hint,e]: gallop towards e
+  ++hint;
+  while (e - hint > step && c(hint[step - 1], x)) {
+    hint += step;
+    step *= 2;
+  }
+  e = e - hint > step ? hint + step - 1 : e;
+  return algs::lower_bound(hint, e, x, c);
+}
+
+/*!
+ * Finds the first element not less than x in the sorted sequence [b,e),
+ * searching outwards from hint in steps that double
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param hint random access iter in [b,e] where the search starts
+ * @param x target value for search
+ *
+ * @returns a random access iter to the first element not less than x, or e
+ */
+template <class RandomIt, class X>
+RandomIt exponential_lower_bound(RandomIt b, RandomIt e, RandomIt hint,
+                                 const X &x) {
+  return algs::exponential_lower_bound(b, e, hint, x, detail::less());
+}
+
+/*!
+ * Performs exponential (galloping) search on the sorted sequence [b,e),
+ * starting at hint, which is cheap when x is close to hint
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param hint random access iter in [b,e] where the search starts
+ * @param x target value for search
+ * @param c comparator function the sequence is sorted by
+ *
+ * @returns true if target value was found, otherwise false
+ */
+template <class RandomIt, class X, class Compare>
+bool exponential_search(RandomIt b, RandomIt e, RandomIt hint, const X &x,
+                        Compare c) {
+  b = algs::exponential_lower_bound(b, e, hint, x, c);
+  return b != e && !c(x, *b);
+}
+
+/*!
+ * Performs exponential (galloping) search on the sorted sequence [b,e),
+ * starting at hint, which is cheap when x is close to hint
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param hint random access iter in [b,e] where the search starts
+ * @param x target value for search
+ *
+ * @returns true if target value was found, otherwise false
+ */
+template <class RandomIt, class X>
+bool exponential_search(RandomIt b, RandomIt e, RandomIt hint, const X &x) {
+  return algs::exponential_search(b, e, hint, x, detail::less());
+}
+
+namespace detail {
+
+/*!
+ * Number of interpolation steps allowed to shrink the candidates by less than
+ * half before interpolation search switches to galloping
+ */
+const int interpolation_misses = 2;
+
+} /* namespace detail */
+
+/*!
+ * Finds the first element not less than x in the sorted sequence [b,e) of
+ * arithmetic values, probing where x would be if the values were evenly
+ * spread between the ends of the remaining range. That takes about
+ * log log n probes on uniformly distributed values. Probes that keep landing
+ * on the same side of x leave the far end in place, so after a couple of
+ * steps that fail to halve the range the search gallops from the last probe
+ * instead, which bounds the worst case to O(log n).
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param x target value for search
+ *
+ * @returns a random access iter to the first element not less than x, or e
+ */
+template <class RandomIt, class X>
+RandomIt interpolation_lower_bound(RandomIt b, RandomIt e, const X &x) {
+  typedef typename std::iterator_traits<RandomIt>::difference_type Diff;
+  int misses = 0;
+  // The lower bound is in [b,e], with *b < x <= e[-1] while b < e
+  if (b == e || !(*b < x))
+    return b;
+  if (e[-1] < x)
+    return e;
+  RandomIt mid = b;
+  while (e - b > 8) {
+    if (misses == detail::interpolation_misses)
+      return algs::exponential_lower_bound(b, e, mid, x);
+    Diff n = e - b;
+    double lo = static_cast<double>(*b), hi = static_cast<double>(e[-1]);
+    double f = (static_cast<double>(x) - lo) / (hi - lo);
+    // Values too far apart or too close for a double to tell give no
+    // estimate; the probe is strictly inside, since both ends are known
+    Diff guess = f >= 0 && f <= 1 ? static_cast<Diff>(f * (n - 1)) : n / 2;
+    mid = b + (guess < 1 ? 1 : guess > n - 2 ? n - 2 : guess);
+    if (*mid < x)
+      b = mid;
+    else
+      e = mid + 1;
+    misses += 2 * (e - b) > n;
+  }
+  return algs::lower_bound(b, e, x);
+}
+
+/*!
+ * Performs interpolation search on the sorted sequence [b,e) of arithmetic
+ * values
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param x target value for search
+ *
+ * @returns true if target value was found, otherwise false
+ */
+template <class RandomIt, class X>
+bool interpolation_search(RandomIt b, RandomIt e, const X &x) {
+  b = algs::interpolation_lower_bound(b, e, x);
+  return b != e && !(x < *b);
+}
+
+namespace detail {
+
+/*!
+ * @returns y - x as a double, for x <= y; exact for integers as long as the
+ * difference is, even when it overflows their signed type
+ */
+template <class T> double key_distance(const T &x, const T &y, true_type) {
+  return static_cast<double>(static_cast<unsigned long long>(y) -
+                             static_cast<unsigned long long>(x));
+}
+
+template <class T> double key_distance(const T &x, const T &y, false_type) {
+  return static_cast<double>(y) - static_cast<double>(x);
+}
+
+template <class T> double key_distance(const T &x, const T &y) {
+  return key_distance(x, y, bool_type<is_integral<T>::value>());
+}
+
+} /* namespace detail */
+
+/*!
+ * Learned index over a sorted sequence of arithmetic values: a piecewise
+ * linear model predicting the position of every distinct value to within a
+ * given error. Queries pick the segment covering x, search the few elements
+ * around its prediction, and gallop from there if the result lies outside,
+ * which can only happen for values that are not in the sequence. The index
+ * does not copy the sequence, and queries must be given the same range it was
+ * built from; it takes a few bytes per segment, and smooth data needs few
+ * segments.
+ */
+template <class T> class learned_index {
+public:
+  learned_index() : error(0) {}
+
+  /*!
+   * Builds the index of the sorted sequence [b,e). Segments are grown
+   * greedily, narrowing the range of slopes that keep every value seen so
+   * far within error of its position, and a new one starts when that range
+   * becomes empty.
+   *
+   * @param b random access iter marking the beginning of the sequence
+   * @param e random access iter marking the end of the sequence
+   * @param err largest distance between a predicted and actual position
+   */
+  template <class RandomIt>
+  learned_index(RandomIt b, RandomIt e, std::ptrdiff_t err = 32) : error(err) {
+    std::ptrdiff_t n = e - b;
+    double lo = 0, hi = 0;
+    bool bounded = false;
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+      if (i > 0 && !(b[i - 1] < b[i]))
+        continue;
+      if (!keys.empty()) {
+        double dx = detail::key_distance(keys.back(), b[i]);
+        double p = static_cast<double>(i - starts.back());
+        double l = (p - error) / dx, h = (p + error) / dx;
+        if (!bounded || (l <= hi && h >= lo)) {
+          lo = bounded && lo > l ? lo : l;
+          hi = bounded && hi < h ? hi : h;
+          bounded = true;
+          continue;
+        }
+        slopes.push_back((lo + hi) / 2);
+      }
+      keys.push_back(b[i]);
+      starts.push_back(i);
+      lo = hi = 0;
+      bounded = false;
+    }
+    if (!keys.empty())
+      slopes.push_back((lo + hi) / 2);
+    starts.push_back(n);
+  }
+
+  /*!
+   * @returns the number of linear segments of the model
+   */
+  std::ptrdiff_t segments() const { return std::ptrdiff_t(keys.size()); }
+
+  /*!
+   * Finds the first element not less than x in the indexed sequence
+   *
+   * @param b random access iter marking the beginning of the indexed sequence
+   * @param e random access iter marking the end of the indexed sequence
+   * @param x target value for search
+   *
+   * @returns a random access iter to the first element not less than x, or e
+   */
+  template <class RandomIt>
+  RandomIt lower_bound(RandomIt b, RandomIt e, const T &x) const {
+    if (b == e || !(keys[0] < x))
+      return b;
+    // The result lies between the first positions of segment s and s + 1
+    std::ptrdiff_t s =
+        algs::upper_bound(keys.begin(), keys.end(), x) - keys.begin() - 1;
+    std::ptrdiff_t first = starts[s], last = starts[s + 1];
+    double guess = static_cast<double>(first) +
+                   slopes[s] * detail::key_distance(keys[s], x);
+    std::ptrdiff_t p = first;
+    if (guess >= static_cast<double>(last))
+      p = last;
+    else if (guess > static_cast<double>(first))
+      p = static_cast<std::ptrdiff_t>(guess);
+    std::ptrdiff_t lo = p - error > first ? p - error : first;
+    std::ptrdiff_t hi = p + error + 1 < last ? p + error + 1 : last;
+    RandomIt r = algs::lower_bound(b + lo, b + hi, x);
+    if (r == b + lo && lo != first)
+      return algs::exponential_lower_bound(b + first, r, r, x);
+    if (r == b + hi && hi != last)
+      return algs::exponential_lower_bound(r, b + last, r, x);
+    return r;
+  }
+
+  /*!
+   * @param b random access iter marking the beginning of the indexed sequence
+   * @param e random access iter marking the end of the indexed sequence
+   * @param x target value for search
+   *
+   * @returns true if x is in the indexed sequence
+   */
+  template <class RandomIt>
+  bool contains(RandomIt b, RandomIt e, const T &x) const {
+    b = lower_bound(b, e, x);
+    return b != e && !(x < *b);
+  }
+
+private:
+  std::ptrdiff_t error;
+  std::vector<T> keys;
+  std::vector<double> slopes;
+  std::vector<std::ptrdiff_t> starts;
+};
+
+namespace detail {
+
+/*!
+ * @returns the index of the highest set bit of x, which must be positive
+ */
+inline int floor_log2(std::ptrdiff_t x) {
+#ifdef __GNUC__
+  return int(sizeof(unsigned long long) * 8 - 1) -
+         __builtin_clzll(static_cast<unsigned long long>(x));
+#else
+  int i = 0;
+  while (x >>= 1)
+    ++i;
+  return i;
+#endif
+}
+
+/*!
+ * @returns the number of consecutive set bits at the bottom of x
+ */
+inline int trailing_ones(std::ptrdiff_t x) {
+#ifdef __GNUC__
+  return __builtin_ctzll(~static_cast<unsigned long long>(x));
+#else
+  int i = 0;
+  while (x & 1) {
+    x >>= 1;
+    ++i;
+  }
+  return i;
+#endif
+}
+
+/*!
+ * @returns the index of the lowest set bit of x, which must not be zero
+ */
+inline int trailing_zeros(unsigned x) {
+#ifdef __GNUC__
+  return __builtin_ctz(x);
+#else
+  int i = 0;
+  while (!(x & 1)) {
+    x >>= 1;
+    ++i;
+  }
+  return i;
+#endif
+}
+
+} /* namespace detail */
+
+/*!
+ * Read-only search index over a sorted sequence, holding a copy of the keys in
+ * Eytzinger (breadth first) order: node k has children 2k and 2k+1, so the
+ * first levels of every search share a few cache lines and the nodes four
+ * levels down from any node are contiguous and can be prefetched early.
+ * Results are positions in the sequence the index was built from.
+ */
+template <class T, class Compare = detail::less> class eytzinger_index {
+public:
+  eytzinger_index() : n(0), height(0) {}
+
+  /*!
+   * Builds the index of the sorted sequence [b,e)
+   *
+   * @param b random access iter marking the beginning of the sequence
+   * @param e random access iter marking the end of the sequence
+   * @param c comparator function the sequence is sorted by
+   */
+  template <class RandomIt>
+  eytzinger_index(RandomIt b, RandomIt e, Compare c = Compare())
+      : n(e - b), height(0), comp(c) {
+    if (n == 0)
+      return;
+    height = detail::floor_log2(n) + 1;
+    keys.assign(n + 1, *b);
+    build(b, 0, 1);
+  }
+
+  /*!
+   * @returns the length of the indexed sequence
+   */
+  std::ptrdiff_t size() const { return n; }
+
+  /*!
+   * Finds the first element of the indexed sequence not ordered before x
+   *
+   * @param x target value for search
+   *
+   * @returns the position of that element, or size() if there is none
+   */
+  template <class X> std::ptrdiff_t lower_bound(const X &x) const {
+    return position(descend(x));
+  }
+
+  /*!
+   * @param x target value for search
+   *
+   * @returns true if an element equivalent to x is in the indexed sequence
+   */
+  template <class X> bool contains(const X &x) const {
+    std::ptrdiff_t k = descend(x);
+    Compare c = comp;
+    return k != 0 && !c(x, keys[k]);
+  }
+
+private:
+  template <class RandomIt>
+  std::ptrdiff_t build(RandomIt b, std::ptrdiff_t i, std::ptrdiff_t k) {
+    if (k <= n) {
+      i = build(b, i, 2 * k);
+      keys[k] = b[i++];
+      i = build(b, i, 2 * k + 1);
+    }
+    return i;
+  }
+
+  // Walks down to a leaf going right past every key ordered before x, then
+  // undoes the trailing right turns and the final left one, which leaves the
+  // last node where the search turned left: the lower bound, or 0 if none.
+  // All levels but the last are full, so the loop runs a fixed number of
+  // times and a missing node on the last level counts as a right turn.
+  template <class X> std::ptrdiff_t descend(const X &x) const {
+    Compare c = comp;
+    std::ptrdiff_t k = 1;
+    if (n * std::ptrdiff_t(sizeof(T)) > detail::prefetch_cutoff)
+      for (int level = 1; level < height; ++level) {
+        std::ptrdiff_t first = 16 * k, last = 16 * k + 15;
+        detail::prefetch(&keys[0] + (first < n ? first : n));
+        detail::prefetch(&keys[0] + (last < n ? last : n));
+        k = 2 * k + c(keys[k], x);
+      }
+    else
+      for (int level = 1; level < height; ++level)
+        k = 2 * k + c(keys[k], x);
+    if (n != 0) {
+      bool missing = k > n;
+      k = 2 * k + (c(keys[missing ? 1 : k], x) | missing);
+    }
+    return k >> (detail::trailing_ones(k) + 1);
+  }
+
+  // In-order position of node k: its position in the perfect tree of the same
+  // height, less the missing last level nodes that come before it.
+  std::ptrdiff_t position(std::ptrdiff_t k) const {
+    if (k == 0)
+      return n;
+    int depth = detail::floor_log2(k);
+    std::ptrdiff_t full = (2 * (k - (std::ptrdiff_t(1) << depth)) + 1)
+                          << (height - 1 - depth);
+    std::ptrdiff_t last = n - ((std::ptrdiff_t(1) << (height - 1)) - 1);
+    std::ptrdiff_t missing = full / 2 - last;
+    return full - 1 - (missing > 0 ? missing : 0);
+  }
+
+  std::ptrdiff_t n;
+  int height;
+  Compare comp;
+  std::vector<T> keys;
+};
+
+namespace detail {
+
+/*!
+ * Key stored by static_btree for a value of type T. Integers of 4 and 8 bytes
+ * are stored as signed integers of the same size, with the sign bit of
+ * unsigned values flipped so that signed comparisons order them correctly.
+ */
+template <class T, bool Integral = is_integral<T>::value,
+          std::size_t Size = sizeof(T)>
+struct btree_key {
+  typedef T type;
+  static const T &key(const T &x) { return x; }
+};
+
+template <class T> struct btree_key<T, true, 4> {
+  typedef int type;
+  static int key(T x) {
+    return static_cast<int>(static_cast<unsigned>(x) ^
+                            (T(-1) < T(0) ? 0u : 0x80000000u));
+  }
+};
+
+template <class T> struct btree_key<T, true, 8> {
+  typedef long long type;
+  static long long key(T x) {
+    return static_cast<long long>(
+        static_cast<unsigned long long>(x) ^
+        (T(-1) < T(0) ? 0ull : 0x8000000000000000ull));
+  }
+};
+
+/*!
+ * Counts the keys of a static_btree node of n sorted keys ordered before x
+ */
+template <class K>
+inline std::ptrdiff_t btree_rank(const K *node, const K &x, std::ptrdiff_t n) {
+  std::ptrdiff_t r = 0;
+  for (std::ptrdiff_t i = 0; i < n; ++i)
+    r += node[i] < x;
+  return r;
+}
+
+#ifdef ALGS_SIMD
+// The keys of a node are sorted, so the lanes ordered before x form the low
+// bits of the compare mask and counting its trailing ones gives the rank.
+inline std::ptrdiff_t btree_rank(const int *node, int x, std::ptrdiff_t) {
+#if defined(__AVX512F__)
+  return trailing_ones(_mm512_cmplt_epi32_mask(_mm512_loadu_si512(node),
+                                               _mm512_set1_epi32(x)));
+#elif defined(__AVX2__)
+  __m256i v = _mm256_set1_epi32(x);
+  __m256i lo = _mm256_cmpgt_epi32(v, simd_load(node));
+  __m256i hi = _mm256_cmpgt_epi32(v, simd_load(node + 8));
+  return trailing_ones(_mm256_movemask_ps(_mm256_castsi256_ps(lo)) |
+                       _mm256_movemask_ps(_mm256_castsi256_ps(hi)) << 8);
+#else
+  __m128i v = _mm_set1_epi32(x);
+  __m128i lo = _mm_packs_epi32(_mm_cmpgt_epi32(v, simd_load(node)),
+                               _mm_cmpgt_epi32(v, simd_load(node + 4)));
+  __m128i hi = _mm_packs_epi32(_mm_cmpgt_epi32(v, simd_load(node + 8)),
+                               _mm_cmpgt_epi32(v, simd_load(node + 12)));
+  return trailing_ones(_mm_movemask_epi8(_mm_packs_epi16(lo, hi)));
+#endif
+}
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+inline std::ptrdiff_t btree_rank(const long long *node, long long x,
+                                 std::ptrdiff_t) {
+#if defined(__AVX512F__)
+  return trailing_ones(_mm512_cmplt_epi64_mask(_mm512_loadu_si512(node),
+                                               _mm512_set1_epi64(x)));
+#elif defined(__AVX2__)
+  __m256i v = _mm256_set1_epi64x(x);
+  __m256i lo = _mm256_cmpgt_epi64(v, simd_load(node));
+  __m256i hi = _mm256_cmpgt_epi64(v, simd_load(node + 4));
+  return trailing_ones(_mm256_movemask_pd(_mm256_castsi256_pd(lo)) |
+                       _mm256_movemask_pd(_mm256_castsi256_pd(hi)) << 4);
+#else
+  __m128i v = _mm_set1_epi64x(x);
+  int mask = 0;
+  for (int i = 0; i < 4; ++i)
+    mask |= _mm_movemask_pd(_mm_castsi128_pd(
+                _mm_cmpgt_epi64(v, simd_load(node + 2 * i))))
+            << 2 * i;
+  return trailing_ones(mask);
+#endif
+}
+#endif
+#endif
+
+} /* namespace detail */
+
+/*!
+ * Read-only search index over a sorted sequence laid out as a static B+ tree
+ * whose nodes are one cache line of keys: 16 keys of 4 bytes or 8 of 8 bytes.
+ * The leaves are the sorted keys themselves, and each inner node holds the
+ * largest key under each of its first children, so a node is searched with a
+ * handful of SIMD compares and a query touches one cache line per level,
+ * about a quarter as many levels as a binary search. Elements are compared
+ * with operator<, and other types than integers search nodes with a loop.
+ * Results are positions in the sequence the index was built from.
+ */
+template <class T> class static_btree {
+  typedef typename detail::btree_key<T>::type key_type;
+
+public:
+  /*! Number of keys in a node; inner nodes have one more child than keys */
+  static const std::ptrdiff_t node_size =
+      sizeof(key_type) <= 32 ? 64 / sizeof(key_type) : 2;
+
+  static_btree() : n(0), first(0) {}
+
+  /*!
+   * Builds the index of the sorted sequence [b,e)
+   *
+   * @param b random access iter marking the beginning of the sequence
+   * @param e random access iter marking the end of the sequence
+   */
+  template <class RandomIt> static_btree(RandomIt b, RandomIt e) : n(e - b) {
+    const std::ptrdiff_t B = node_size;
+    if (n == 0) {
+      first = 0;
+      return;
+    }
+    // Levels from the leaves up, each counted in nodes
+    std::vector<std::ptrdiff_t> width(1, (n + B - 1) / B);
+    while (width.back() > 1)
+      width.push_back((width.back() + B) / (B + 1));
+    // The root comes first in memory and the leaves last
+    offset.resize(width.size());
+    std::ptrdiff_t total = 0;
+    for (std::ptrdiff_t l = std::ptrdiff_t(width.size()) - 1; l >= 0; --l) {
+      offset[l] = total;
+      total += width[l] * B;
+    }
+    allocate(total, detail::btree_key<T>::key(*b));
+    key_type *leaves = &keys[first] + offset[0];
+    for (std::ptrdiff_t i = 0; i < total - offset[0]; ++i)
+      leaves[i] = detail::btree_key<T>::key(b[i < n ? i : n - 1]);
+    // Key j of inner node k is the largest key under its child k(B+1)+j,
+    // which for a child beyond the last is the largest key overall
+    std::ptrdiff_t span = B;
+    for (std::size_t l = 1; l < width.size(); ++l) {
+      key_type *node = &keys[first] + offset[l];
+      for (std::ptrdiff_t c = 0; c < width[l] * (B + 1); ++c) {
+        if (c % (B + 1) == B)
+          continue;
+        std::ptrdiff_t last = (c + 1) * span;
+        *node++ = leaves[(last < n ? last : n) - 1];
+      }
+      span *= B + 1;
+    }
+  }
+
+  static_btree(const static_btree &t) : n(t.n), offset(t.offset) {
+    copy(t);
+  }
+
+  static_btree &operator=(const static_btree &t) {
+    if (this != &t) {
+      n = t.n;
+      offset = t.offset;
+      copy(t);
+    }
+    return *this;
+  }
+
+  /*!
+   * @returns the length of the indexed sequence
+   */
+  std::ptrdiff_t size() const { return n; }
+
+  /*!
+   * Finds the first element of the indexed sequence not less than x
+   *
+   * @param x target value for search
+   *
+   * @returns the position of that element, or size() if there is none
+   */
+  std::ptrdiff_t lower_bound(const T &x) const {
+    return descend(detail::btree_key<T>::key(x));
+  }
+
+  /*!
+   * @param x target value for search
+   *
+   * @returns true if an element equal to x is in the indexed sequence
+   */
+  bool contains(const T &x) const {
+    key_type y = detail::btree_key<T>::key(x);
+    std::ptrdiff_t i = descend(y);
+    return i != n && !(y < keys[first + offset[0] + i]);
+  }
+
+private:
+  // Values past the largest key would lead to children beyond the last, so
+  // they are answered before descending.
+  std::ptrdiff_t descend(const key_type &y) const {
+    const std::ptrdiff_t B = node_size;
+    const key_type *base = n == 0 ? 0 : &keys[first];
+    if (n == 0 || base[offset[0] + n - 1] < y)
+      return n;
+    std::ptrdiff_t k = 0;
+    for (std::ptrdiff_t l = std::ptrdiff_t(offset.size()) - 1; l > 0; --l)
+      k = k * (B + 1) + detail::btree_rank(base + offset[l] + k * B, y, B);
+    return k * B + detail::btree_rank(base + offset[0] + k * B, y, B);
+  }
+
+  // Over-allocates by a node so the nodes can start on a cache line
+  void allocate(std::ptrdiff_t total, const key_type &fill) {
+    keys.assign(total + node_size, fill);
+    for (first = 0; first < node_size - 1; ++first)
+      if (reinterpret_cast<std::size_t>(&keys[first]) % 64 == 0)
+        break;
+  }
+
+  void copy(const static_btree &t) {
+    if (t.keys.empty()) {
+      keys.clear();
+      first = 0;
+      return;
+    }
+    std::ptrdiff_t total = std::ptrdiff_t(t.keys.size()) - node_size;
+    allocate(total, t.keys[0]);
+    for (std::ptrdiff_t i = 0; i < total; ++i)
+      keys[first + i] = t.keys[t.first + i];
+  }
+
+  std::ptrdiff_t n, first;
+  std::vector<std::ptrdiff_t> offset;
+  std::vector<key_type> keys;
+};
+
+template <class T> const std::ptrdiff_t static_btree<T>::node_size;
+
+namespace detail {
+
+/*!
+ * Size ratio beyond which the set operations gallop through the larger range
+ * for each element of the smaller one instead of merging the two
+ */
+const std::ptrdiff_t set_gallop_ratio = 32;
+
+/*!
+ * Number of results the branchless set kernels stage before writing them out
+ */
+const int set_buffer = 256;
+
+/*!
+ * True when the set operations on It1 and It2 with Compare can use the
+ * branchless kernels: both contiguous over the same integer type, compared
+ * with operator<
+ */
+template <class It1, class It2, class Compare,
+          bool Contiguous = contiguous<It1>::value>
+struct set_branchless : false_type {};
+template <class It1, class It2, class Compare>
+struct set_branchless<It1, It2, Compare, true>
+    : bool_type<is_same<Compare, less>::value &&
+                is_integral<typename contiguous<It1>::value_type>::value &&
+                contiguous_of<It2, typename contiguous<It1>::value_type>::
+                    value> {};
+
+/*!
+ * Counts the elements assigned through it in place of storing them
+ */
+struct counting_iterator {
+  std::ptrdiff_t n;
+
+  counting_iterator &operator*() { return *this; }
+  template <class X> counting_iterator &operator=(const X &) {
+    ++n;
+    return *this;
+  }
+  counting_iterator &operator++() { return *this; }
+  counting_iterator &operator++(int) { return *this; }
+};
+
+/*!
+ * @returns true when one of two ranges of lengths n1 and n2 is so much
+ * shorter that searching the other for each of its elements is cheaper
+ */
+inline bool set_skewed(std::ptrdiff_t n1, std::ptrdiff_t n2) {
+  return n1 / set_gallop_ratio > n2 || n2 / set_gallop_ratio > n1;
+}
+
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt set_intersection(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+                          OutputIt d, Compare &c, std::input_iterator_tag,
+                          std::input_iterator_tag) {
+  while (b1 != e1 && b2 != e2) {
+    if (c(*b1, *b2))
+      ++b1;
+    else if (c(*b2, *b1))
+      ++b2;
+    else {
+      *d = *b1;
+      ++d;
+      ++b1;
+      ++b2;
+    }
+  }
+  return d;
+}
+
+template <class RandomIt1, class RandomIt2, class OutputIt, class Compare>
+OutputIt set_intersection_gallop(RandomIt1 b1, RandomIt1 e1, RandomIt2 b2,
+                                 RandomIt2 e2, OutputIt d, Compare &c) {
+  if (e1 - b1 < e2 - b2) {
+    for (; b1 != e1 && b2 != e2; ++b1) {
+      b2 = algs::exponential_lower_bound(b2, e2, b2, *b1, c);
+      if (b2 != e2 && !c(*b1, *b2)) {
+        *d = *b1;
+        ++d;
+        ++b2;
+      }
+    }
+  } else {
+    for (; b1 != e1 && b2 != e2; ++b2) {
+      b1 = algs::exponential_lower_bound(b1, e1, b1, *b2, c);
+      if (b1 != e1 && !c(*b2, *b1)) {
+        *d = *b1;
+        ++d;
+        ++b1;
+      }
+    }
+  }
+  return d;
+}
+
+// Every step stores the smaller element to the staging buffer but only keeps
+// it when both are equal, and advances past whichever is smaller, so that the
+// loop has no data dependent branches.
+template <class T, class OutputIt>
+OutputIt set_intersection_branchless(const T *b1, const T *e1, const T *b2,
+                                     const T *e2, OutputIt d) {
+  T buf[set_buffer];
+  int k = 0;
+  while (b1 != e1 && b2 != e2) {
+    T x = *b1, y = *b2;
+    buf[k] = x;
+    k += x == y;
+    b1 += x <= y;
+    b2 += y <= x;
+    if (k == set_buffer) {
+      d = algs::copy(buf, buf + k, d);
+      k = 0;
+    }
+  }
+  return algs::copy(buf, buf + k, d);
+}
+
+template <class T, class OutputIt>
+OutputIt set_intersection_block(const T *b1, const T *e1, const T *b2,
+                                const T *e2, OutputIt d) {
+  return set_intersection_branchless(b1, e1, b2, e2, d);
+}
+
+#ifdef ALGS_SIMD
+#ifdef __AVX2__
+const int set_block = 8;
+
+inline unsigned set_block_matches(const void *a, const void *b) {
+  const simd_vec rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+  simd_vec va = simd_load(a), vb = simd_load(b);
+  simd_vec m = _mm256_cmpeq_epi32(va, vb);
+  for (int r = 1; r < set_block; ++r) {
+    vb = _mm256_permutevar8x32_epi32(vb, rotate);
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+  }
+  return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+}
+
+inline bool set_block_repeats(const void *a) {
+  const int *p = static_cast<const int *>(a);
+  return _mm256_movemask_epi8(_mm256_cmpeq_epi32(simd_load(p),
+                                                 simd_load(p + 1))) != 0;
+}
+#else
+const int set_block = 4;
+
+inline unsigned set_block_matches(const void *a, const void *b) {
+  simd_vec va = simd_load(a), vb = simd_load(b);
+  simd_vec m = _mm_cmpeq_epi32(va, vb);
+  for (int r = 1; r < set_block; ++r) {
+    vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(va, vb));
+  }
+  return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m)));
+}
+
+inline bool set_block_repeats(const void *a) {
+  const int *p = static_cast<const int *>(a);
+  return _mm_movemask_epi8(_mm_cmpeq_epi32(simd_load(p), simd_load(p + 1))) !=
+         0;
+}
+#endif
+
+// Compares a block of each range against all rotations of the other, keeps
+// the matches of the first block and advances the block with the smaller
+// last element, or both. A value repeated within or just past either block
+// could match twice, so such steps are taken one element at a time instead.
+template <class T, class OutputIt>
+OutputIt set_intersection_simd(const T *b1, const T *e1, const T *b2,
+                               const T *e2, OutputIt d) {
+  T buf[set_buffer];
+  int k = 0;
+  while (e1 - b1 > set_block && e2 - b2 > set_block) {
+    if (set_block_repeats(b1) || set_block_repeats(b2)) {
+      T x = *b1, y = *b2;
+      buf[k] = x;
+      k += x == y;
+      b1 += x <= y;
+      b2 += y <= x;
+    } else {
+      unsigned m = set_block_matches(b1, b2);
+#if defined(__AVX512VL__) && defined(__AVX2__)
+      _mm256_mask_compressstoreu_epi32(buf + k, static_cast<__mmask8>(m),
+                                       simd_load(b1));
+      k += __builtin_popcount(m);
+#else
+      for (; m != 0; m &= m - 1)
+        buf[k++] = b1[trailing_zeros(m)];
+#endif
+      T x = b1[set_block - 1], y = b2[set_block - 1];
+      b1 += (x <= y) * set_block;
+      b2 += (y <= x) * set_block;
+    }
+    if (k > set_buffer - set_block) {
+      d = algs::copy(buf, buf + k, d);
+      k = 0;
+    }
+  }
+  d = algs::copy(buf, buf + k, d);
+  return set_intersection_branchless(b1, e1, b2, e2, d);
+}
+
+template <class OutputIt>
+OutputIt set_intersection_block(const int *b1, const int *e1, const int *b2,
+                                const int *e2, OutputIt d) {
+  return set_intersection_simd(b1, e1, b2, e2, d);
+}
+
+template <class OutputIt>
+OutputIt set_intersection_block(const unsigned *b1, const unsigned *e1,
+                                const unsigned *b2, const unsigned *e2,
+                                OutputIt d) {
+  return set_intersection_simd(b1, e1, b2, e2, d);
+}
+#endif
+
+template <class RandomIt1, class RandomIt2, class OutputIt, class Compare>
+OutputIt set_intersection_merge(RandomIt1 b1, RandomIt1 e1, RandomIt2 b2,
+                                RandomIt2 e2, OutputIt d, Compare &c,
+                                false_type) {
+  return set_intersection(b1, e1, b2, e2, d, c, std::input_iterator_tag(),
+                          std::input_iterator_tag());
+}
+
+template <class RandomIt1, class RandomIt2, class OutputIt, class Compare>
+OutputIt set_intersection_merge(RandomIt1 b1, RandomIt1 e1, RandomIt2 b2,
+                                RandomIt2 e2, OutputIt d, Compare &,
+                                true_type) {
+  return set_intersection_block(
+      contiguous<RandomIt1>::ptr(b1), contiguous<RandomIt1>::ptr(e1),
+      contiguous<RandomIt2>::ptr(b2), contiguous<RandomIt2>::ptr(e2), d);
+}
+
+template <class RandomIt1, class RandomIt2, class OutputIt, class Compare>
+OutputIt set_intersection(RandomIt1 b1, RandomIt1 e1, RandomIt2 b2,
+                          RandomIt2 e2, OutputIt d, Compare &c,
+                          std::random_access_iterator_tag,
+                          std::random_access_iterator_tag) {
+  if (set_skewed(e1 - b1, e2 - b2))
+    return set_intersection_gallop(b1, e1, b2, e2, d, c);
+  return set_intersection_merge(
+      b1, e1, b2, e2, d, c,
+      bool_type<set_branchless<RandomIt1, RandomIt2, Compare>::value>());
+}
+
+} /* namespace detail */
+
+/*!
+ * Copies the elements common to the sorted sequences [b1,e1) and [b2,e2) to
+ * d; an element found m times in the first and n times in the second is
+ * copied min(m,n) times, from the first. Very differently sized ranges are
+ * intersected by galloping through the larger, and ranges of integers held
+ * contiguously are merged without branches, a SIMD block at a time for 32-bit
+ * integers.
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param d output iter marking the beginning of the destination
+ * @param c comparator function both sequences are sorted by
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt set_intersection(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+                          OutputIt d, Compare c) {
+  return detail::set_intersection(
+      b1, e1, b2, e2, d, c,
+      typename std::iterator_traits<InputIt1>::iterator_category(),
+      typename std::iterator_traits<InputIt2>::iterator_category());
+}
+
+/*!
+ * Copies the elements common to the sorted sequences [b1,e1) and [b2,e2) to
+ * d, compared with operator<
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param d output iter marking the beginning of the destination
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class InputIt1, class InputIt2, class OutputIt>
+OutputIt set_intersection(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+                          OutputIt d) {
+  return algs::set_intersection(b1, e1, b2, e2, d, detail::less());
+}
+
+/*!
+ * Counts the elements set_intersection would copy, without storing them
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param c comparator function both sequences are sorted by
+ *
+ * @returns the size of the intersection
+ */
+template <class InputIt1, class InputIt2, class Compare>
+std::ptrdiff_t set_intersection_size(InputIt1 b1, InputIt1 e1, InputIt2 b2,
+                                     InputIt2 e2, Compare c) {
+  detail::counting_iterator d = {0};
+  return algs::set_intersection(b1, e1, b2, e2, d, c).n;
+}
+
+/*!
+ * Counts the elements set_intersection would copy, without storing them
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ *
+ * @returns the size of the intersection
+ */
+template <class InputIt1, class InputIt2>
+std::ptrdiff_t set_intersection_size(InputIt1 b1, InputIt1 e1, InputIt2 b2,
+                                     InputIt2 e2) {
+  return algs::set_intersection_size(b1, e1, b2, e2, detail::less());
+}
+
+namespace detail {
+
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt set_union(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+                   OutputIt d, Compare &c, std::input_iterator_tag,
+                   std::input_iterator_tag) {
+  for (; b1 != e1 && b2 != e2; ++d) {
+    if (c(*b2, *b1)) {
+      *d = *b2;
+      ++b2;
+    } else {
+      if (!c(*b1, *b2))
+        ++b2;
+      *d = *b1;
+      ++b1;
+    }
+  }
+  return algs::copy(b2, e2, algs::copy(b1, e1, d));
+}
+
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt set_difference(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+                        OutputIt d, Compare &c, std::input_iterator_tag,
+                        std::input_iterator_tag) {
+  while (b1 != e1 && b2 != e2) {
+    if (c(*b1, *b2)) {
+      *d = *b1;
+      ++d;
+      ++b1;
+    } else {
+      if (!c(*b2, *b1))
+        ++b1;
+      ++b2;
+    }
+  }
+  return algs::copy(b1, e1, d);
+}
+
+// Only pays off when the first range is the much shorter one, since
+// otherwise most of the time goes to copying the first range anyway
+template <class RandomIt1, class RandomIt2, class OutputIt, class Compare>
+OutputIt set_difference(RandomIt1 b1, RandomIt1 e1, RandomIt2 b2,
+                        RandomIt2 e2, OutputIt d, Compare &c,
+                        std::random_access_iterator_tag,
+                        std::random_access_iterator_tag) {
+  if ((e2 - b2) / set_gallop_ratio <= e1 - b1)
+    return set_difference(b1, e1, b2, e2, d, c, std::input_iterator_tag(),
+                          std::input_iterator_tag());
+  for (; b1 != e1; ++b1) {
+    b2 = algs::exponential_lower_bound(b2, e2, b2, *b1, c);
+    if (b2 != e2 && !c(*b1, *b2))
+      ++b2;
+    else {
+      *d = *b1;
+      ++d;
+    }
+  }
+  return d;
+}
+
+template <class InputIt1, class InputIt2, class Compare>
+bool includes(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2, Compare &c,
+              std::input_iterator_tag, std::input_iterator_tag) {
+  for (; b2 != e2; ++b1) {
+    if (b1 == e1 || c(*b2, *b1))
+      return false;
+    if (!c(*b1, *b2))
+      ++b2;
+  }
+  return true;
+}
+
+template <class RandomIt1, class RandomIt2, class Compare>
+bool includes(RandomIt1 b1, RandomIt1 e1, RandomIt2 b2, RandomIt2 e2,
+              Compare &c, std::random_access_iterator_tag,
+              std::random_access_iterator_tag) {
+  if (e1 - b1 < e2 - b2)
+    return false;
+  if ((e1 - b1) / set_gallop_ratio <= e2 - b2)
+    return includes(b1, e1, b2, e2, c, std::input_iterator_tag(),
+                    std::input_iterator_tag());
+  for (; b2 != e2; ++b2, ++b1) {
+    b1 = algs::exponential_lower_bound(b1, e1, b1, *b2, c);
+    if (b1 == e1 || c(*b2, *b1))
+      return false;
+  }
+  return true;
+}
+
+} /* namespace detail */
+
+/*!
+ * Merges the sorted sequences [b1,e1) and [b2,e2) into d, keeping an element
+ * found m times in the first and n times in the second max(m,n) times, with
+ * the equivalent elements of the first copied first
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param d output iter marking the beginning of the destination
+ * @param c comparator function both sequences are sorted by
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt set_union(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+                   OutputIt d, Compare c) {
+  return detail::set_union(
+      b1, e1, b2, e2, d, c,
+      typename std::iterator_traits<InputIt1>::iterator_category(),
+      typename std::iterator_traits<InputIt2>::iterator_category());
+}
+
+/*!
+ * Merges the sorted sequences [b1,e1) and [b2,e2) into d, compared with
+ * operator<, keeping common elements once for each time both contain them
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param d output iter marking the beginning of the destination
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class InputIt1, class InputIt2, class OutputIt>
+OutputIt set_union(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+                   OutputIt d) {
+  return algs::set_union(b1, e1, b2, e2, d, detail::less());
+}
+
+/*!
+ * Copies the elements of the sorted sequence [b1,e1) not found in the sorted
+ * sequence [b2,e2) to d; an element found m times in the first and n times in
+ * the second is copied max(m-n,0) times
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param d output iter marking the beginning of the destination
+ * @param c comparator function both sequences are sorted by
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt set_difference(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+                        OutputIt d, Compare c) {
+  return detail::set_difference(
+      b1, e1, b2, e2, d, c,
+      typename std::iterator_traits<InputIt1>::iterator_category(),
+      typename std::iterator_traits<InputIt2>::iterator_category());
+}
+
+/*!
+ * Copies the elements of the sorted sequence [b1,e1) not found in the sorted
+ * sequence [b2,e2) to d, compared with operator<
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param d output iter marking the beginning of the destination
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class InputIt1, class InputIt2, class OutputIt>
+OutputIt set_difference(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+                        OutputIt d) {
+  return algs::set_difference(b1, e1, b2, e2, d, detail::less());
+}
+
+/*!
+ * Tests whether the sorted sequence [b1,e1) contains the sorted sequence
+ * [b2,e2), each element at least as many times as the second does
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param c comparator function both sequences are sorted by
+ *
+ * @returns true if every element of the second sequence is in the first
+ */
+template <class InputIt1, class InputIt2, class Compare>
+bool includes(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2, Compare c) {
+  return detail::includes(
+      b1, e1, b2, e2, c,
+      typename std::iterator_traits<InputIt1>::iterator_category(),
+      typename std::iterator_traits<InputIt2>::iterator_category());
+}
+
+/*!
+ * Tests whether the sorted sequence [b1,e1) contains the sorted sequence
+ * [b2,e2), compared with operator<
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ *
+ * @returns true if every element of the second sequence is in the first
+ */
+template <class InputIt1, class InputIt2>
+bool includes(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2) {
+  return algs::includes(b1, e1, b2, e2, detail::less());
+}
+
+namespace detail {
+
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt merge(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2, OutputIt d,
+               Compare &c, false_type) {
+  for (; b1 != e1 && b2 != e2; ++d) {
+    if (c(*b2, *b1)) {
+      *d = *b2;
+      ++b2;
+    } else {
+      *d = *b1;
+      ++b1;
+    }
+  }
+  return algs::copy(b2, e2, algs::copy(b1, e1, d));
+}
+
+/*!
+ * Merge of contiguous integers selecting the next element and advancing
+ * either input with arithmetic, so that the outcome of each comparison,
+ * random for interleaved inputs, never costs a mispredicted branch
+ */
+template <class It1, class It2, class OutputIt, class Compare>
+OutputIt merge(It1 b1, It1 e1, It2 b2, It2 e2, OutputIt d, Compare &c,
+               true_type) {
+  typedef typename contiguous<It1>::value_type T;
+  const T *p1 = contiguous<It1>::ptr(b1), *q1 = p1 + (e1 - b1);
+  const T *p2 = contiguous<It2>::ptr(b2), *q2 = p2 + (e2 - b2);
+  while (p1 != q1 && p2 != q2) {
+    T x = *p1, y = *p2;
+    bool t = c(y, x);
+    *d = t ? y : x;
+    ++d;
+    p1 += !t;
+    p2 += t;
+  }
+  return algs::copy(p2, q2, algs::copy(p1, q1, d));
+}
+
+/*!
+ * Number of elements the first of two sorted sequences contributes to the
+ * first k elements of their stable merge: the point where diagonal k of the
+ * merge path crosses it, found by binary search along the diagonal
+ */
+template <class RandomIt1, class RandomIt2, class Compare>
+std::ptrdiff_t merge_path(RandomIt1 b1, std::ptrdiff_t n1, RandomIt2 b2,
+                          std::ptrdiff_t n2, std::ptrdiff_t k, Compare &c) {
+  std::ptrdiff_t lo = k > n2 ? k - n2 : 0, hi = k < n1 ? k : n1;
+  while (lo < hi) {
+    std::ptrdiff_t mid = lo + (hi - lo) / 2;
+    if (c(b2[k - mid - 1], b1[mid]))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+/*!
+ * Parallel task merging the elements of output chunk i, with the inputs split
+ * where the merge path crosses the diagonals bounding the chunk
+ */
+template <class RandomIt1, class RandomIt2, class RandomIt3, class Compare>
+struct merge_chunk {
+  RandomIt1 b1;
+  RandomIt2 b2;
+  RandomIt3 d;
+  std::ptrdiff_t n1, n2, k;
+  Compare c;
+
+  void operator()(std::ptrdiff_t i) const {
+    Compare cmp = c;
+    std::ptrdiff_t n = n1 + n2;
+    std::ptrdiff_t lo = chunk_begin(n, k, i), hi = chunk_begin(n, k, i + 1);
+    std::ptrdiff_t l1 = merge_path(b1, n1, b2, n2, lo, cmp);
+    std::ptrdiff_t h1 = merge_path(b1, n1, b2, n2, hi, cmp);
+    detail::merge(b1 + l1, b1 + h1, b2 + (lo - l1), b2 + (hi - h1), d + lo,
+                  cmp,
+                  bool_type<set_branchless<RandomIt1, RandomIt2,
+                                           Compare>::value>());
+  }
+};
+
+/*!
+ * Merges the sorted runs [b,m) of n1 and [m,e) of n2 elements in place using
+ * buffer buf of len constructed elements. When the shorter run fits in the
+ * buffer it is moved out and merged back in one linear pass; otherwise the
+ * longer run is split in half, the other at the matching bound, and the two
+ * middle pieces are swapped with a rotation, giving two smaller merges.
+ */
+template <class BidirectionalIt, class Compare, class T>
+void inplace_merge(BidirectionalIt b, BidirectionalIt m, BidirectionalIt e,
+                   Compare &c, std::ptrdiff_t n1, std::ptrdiff_t n2, T *buf,
+                   std::ptrdiff_t len) {
+  if (n1 == 0 || n2 == 0)
+    return;
+  if (n1 + n2 == 2) {
+    if (c(*m, *b))
+      algs::swap(*b, *m);
+    return;
+  }
+  if (n1 <= n2 && n1 <= len) {
+    // the output never overtakes the unread part of the second run
+    T *te = algs::copy(b, m, buf);
+    detail::merge(buf, te, m, e, b, c,
+                  bool_type<set_branchless<T *, BidirectionalIt,
+                                           Compare>::value>());
+    return;
+  }
+  if (n2 <= len) {
+    T *t = buf, *te = algs::copy(m, e, buf);
+    while (t != te && b != m) {
+      BidirectionalIt l = m;
+      --l;
+      if (c(*(te - 1), *l)) {
+        *--e = *l;
+        m = l;
+      } else
+        *--e = *--te;
+    }
+    while (t != te)
+      *--e = *--te;
+    return;
+  }
+  BidirectionalIt f = b, s = m;
+  std::ptrdiff_t d1, d2;
+  if (n1 > n2) {
+    d1 = n1 / 2;
+    std::advance(f, d1);
+    s = algs::lower_bound(m, e, *f, c);
+    d2 = std::distance(m, s);
+  } else {
+    d2 = n2 / 2;
+    std::advance(s, d2);
+    f = algs::upper_bound(b, m, *s, c);
+    d1 = std::distance(b, f);
+  }
+  BidirectionalIt nm = algs::rotate(f, m, s);
+  detail::inplace_merge(b, f, nm, c, d1, d2, buf, len);
+  detail::inplace_merge(nm, s, e, c, n1 - d1, n2 - d2, buf, len);
+}
+
+} /* namespace detail */
+
+/*!
+ * Merges the sorted sequences [b1,e1) and [b2,e2) into d. The merge is
+ * stable: equivalent elements keep their order, those of the first sequence
+ * before those of the second. Contiguous integers compared with operator<
+ * are merged without data dependent branches.
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param d output iter marking the beginning of the destination
+ * @param c comparator function both sequences are sorted by
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt merge(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2, OutputIt d,
+               Compare c) {
+  return detail::merge(
+      b1, e1, b2, e2, d, c,
+      detail::bool_type<
+          detail::set_branchless<InputIt1, InputIt2, Compare>::value>());
+}
+
+/*!
+ * Merges the sorted sequences [b1,e1) and [b2,e2) into d, compared with
+ * operator<
+ *
+ * @param b1 input iter marking the beginning of the first sequence
+ * @param e1 input iter marking the end of the first sequence
+ * @param b2 input iter marking the beginning of the second sequence
+ * @param e2 input iter marking the end of the second sequence
+ * @param d output iter marking the beginning of the destination
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class InputIt1, class InputIt2, class OutputIt>
+OutputIt merge(InputIt1 b1, InputIt1 e1, InputIt2 b2, InputIt2 e2,
+               OutputIt d) {
+  return algs::merge(b1, e1, b2, e2, d, detail::less());
+}
+
+/*!
+ * Parallel version of merge. The output is cut into one chunk per thread and
+ * each thread locates the inputs feeding its chunk by a binary search along
+ * the merge path, then merges them serially, so every thread writes an equal
+ * share of the output whatever the distribution of the inputs.
+ *
+ * @param b1 random access iter marking the beginning of the first sequence
+ * @param e1 random access iter marking the end of the first sequence
+ * @param b2 random access iter marking the beginning of the second sequence
+ * @param e2 random access iter marking the end of the second sequence
+ * @param d random access iter marking the beginning of the destination
+ * @param c comparator function both sequences are sorted by
+ *
+ * @returns random access iter marking the end of the destination
+ */
+template <class RandomIt1, class RandomIt2, class RandomIt3, class Compare>
+RandomIt3 merge(const parallel_policy &, RandomIt1 b1, RandomIt1 e1,
+                RandomIt2 b2, RandomIt2 e2, RandomIt3 d, Compare c) {
+  std::ptrdiff_t n1 = e1 - b1, n2 = e2 - b2;
+  std::ptrdiff_t k = detail::chunk_count(n1 + n2);
+  if (k == 1)
+    return algs::merge(b1, e1, b2, e2, d, c);
+  detail::merge_chunk<RandomIt1, RandomIt2, RandomIt3, Compare> task = {
+      b1, b2, d, n1, n2, k, c};
+  detail::parallel_for(k, task);
+  return d + (n1 + n2);
+}
+
+/*!
+ * Parallel version of merge compared with operator<
+ *
+ * @param b1 random access iter marking the beginning of the first sequence
+ * @param e1 random access iter marking the end of the first sequence
+ * @param b2 random access iter marking the beginning of the second sequence
+ * @param e2 random access iter marking the end of the second sequence
+ * @param d random access iter marking the beginning of the destination
+ *
+ * @returns random access iter marking the end of the destination
+ */
+template <class RandomIt1, class RandomIt2, class RandomIt3>
+RandomIt3 merge(const parallel_policy &p, RandomIt1 b1, RandomIt1 e1,
+                RandomIt2 b2, RandomIt2 e2, RandomIt3 d) {
+  return algs::merge(p, b1, e1, b2, e2, d, detail::less());
+}
+
+/*!
+ * Merges the consecutive sorted runs [b,m) and [m,e) into the sorted sequence
+ * [b,e), stably. Elements of the first run already in place at the front and
+ * of the second at the back are skipped with binary searches. Runs in linear
+ * time when a temporary buffer for the shorter remaining run can be
+ * allocated, and degrades to an in-place O(n log n) algorithm otherwise.
+ *
+ * @param b bidirectional iter marking the beginning of the first run
+ * @param m bidirectional iter marking the beginning of the second run
+ * @param e bidirectional iter marking the end of the second run
+ * @param c comparator function both runs are sorted by
+ */
+template <class BidirectionalIt, class Compare>
+void inplace_merge(BidirectionalIt b, BidirectionalIt m, BidirectionalIt e,
+                   Compare c) {
+  typedef typename std::iterator_traits<BidirectionalIt>::value_type T;
+  if (b == m || m == e)
+    return;
+  BidirectionalIt l = m;
+  --l;
+  if (!c(*m, *l))
+    return;
+  b = algs::upper_bound(b, m, *m, c);
+  e = algs::lower_bound(m, e, *l, c);
+  std::ptrdiff_t n1 = std::distance(b, m), n2 = std::distance(m, e);
+  detail::temporary_buffer<T> buf(n1 < n2 ? n1 : n2);
+  if (buf.size() > 0)
+    buf.fill(*b);
+  detail::inplace_merge(b, m, e, c, n1, n2, buf.data(), buf.size());
+}
+
+/*!
+ * Merges the consecutive sorted runs [b,m) and [m,e) as above, using a
+ * caller-owned scratch buffer instead of allocating one. A buffer as long as
+ * the shorter run gives linear time; a shorter one, or none, is used for the
+ * largest merges that fit.
+ *
+ * @param b bidirectional iter marking the beginning of the first run
+ * @param m bidirectional iter marking the beginning of the second run
+ * @param e bidirectional iter marking the end of the second run
+ * @param c comparator function both runs are sorted by
+ * @param buf pointer to len constructed elements that may be overwritten
+ * @param len number of elements in the scratch buffer
+ */
+template <class BidirectionalIt, class Compare, class T>
+void inplace_merge(BidirectionalIt b, BidirectionalIt m, BidirectionalIt e,
+                   Compare c, T *buf, std::ptrdiff_t len) {
+  detail::inplace_merge(b, m, e, c, std::distance(b, m), std::distance(m, e),
+                        buf, len);
+}
+
+/*!
+ * Merges the consecutive sorted runs [b,m) and [m,e) into the sorted sequence
+ * [b,e), compared with operator<
+ *
+ * @param b bidirectional iter marking the beginning of the first run
+ * @param m bidirectional iter marking the beginning of the second run
+ * @param e bidirectional iter marking the end of the second run
+ */
+template <class BidirectionalIt>
+void inplace_merge(BidirectionalIt b, BidirectionalIt m, BidirectionalIt e) {
+  algs::inplace_merge(b, m, e, detail::less());
+}
+
+namespace detail {
+
+/*!
+ * Tuning constants of the adaptive merge sort: runs shorter than the minimum
+ * run length, which is between half this and this, are extended by insertion
+ * sort, and merges switch to galloping after this many wins in a row
+ */
+const std::ptrdiff_t stable_sort_min_run = 64;
+const std::ptrdiff_t stable_sort_min_gallop = 7;
+
+/*!
+ * Comparator ordering y before x unless x is ordered before y, turning the
+ * lower bound searches into upper bound ones
+ */
+template <class Compare> struct not_after_compare {
+  Compare c;
+
+  template <class Y, class X> bool operator()(const Y &y, const X &x) {
+    return !c(x, y);
+  }
+};
+
+/*!
+ * Minimum run length for n elements, chosen so that n divided by it is close
+ * to, and no more than, a power of two, which keeps the final merges balanced
+ */
+inline std::ptrdiff_t min_run(std::ptrdiff_t n) {
+  std::ptrdiff_t r = 0;
+  while (n >= stable_sort_min_run) {
+    r |= n & 1;
+    n >>= 1;
+  }
+  return n + r;
+}
+
+/*!
+ * Finds the end of the run starting at b, reversing it into ascending order
+ * if it is strictly descending, which is the case that keeps the sort stable
+ */
+template <class RandomIt, class Compare>
+RandomIt natural_run(RandomIt b, RandomIt e, Compare &c) {
+  RandomIt it = b + 1;
+  if (it == e)
+    return e;
+  if (c(*it, *b)) {
+    while (++it != e && c(*it, it[-1]))
+      ;
+    algs::reverse(b, it);
+  } else
+    while (++it != e && !c(*it, it[-1]))
+      ;
+  return it;
+}
+
+/*!
+ * Merges the run held in buffer [t,te) with the run [m,e) that follows its
+ * original place, writing forward from d. Elements are taken one at a time
+ * until one side wins min_gallop times in a row; the merge then gallops,
+ * moving whole blocks found by exponential search, for as long as the blocks
+ * stay long, and min_gallop adapts to how well galloping has paid off. The
+ * one at a time steps select and advance with arithmetic, as in merge.
+ */
+template <class RandomIt, class T, class Compare>
+void merge_low(RandomIt d, T *t, T *te, RandomIt m, RandomIt e, Compare &c,
+               std::ptrdiff_t &min_gallop) {
+  not_after_compare<Compare> upper = {c};
+  while (t != te && m != e) {
+    std::ptrdiff_t wa = 0, wb = 0;
+    while (t != te && m != e && wa + wb < min_gallop) {
+      bool s = c(*m, *t);
+      *d++ = s ? *m : *t;
+      m += s;
+      t += !s;
+      wb = (wb + 1) * s;
+      wa = (wa + 1) * !s;
+    }
+    while (t != te && m != e) {
+      T *p = algs::exponential_lower_bound(t, te, t, *m, upper);
+      wa = p - t;
+      d = algs::copy(t, p, d);
+      t = p;
+      if (t == te)
+        break;
+      RandomIt q = algs::exponential_lower_bound(m, e, m, *t, c);
+      wb = q - m;
+      d = algs::copy(m, q, d);
+      m = q;
+      if (wa < stable_sort_min_gallop && wb < stable_sort_min_gallop) {
+        min_gallop += 2;
+        break;
+      }
+      if (min_gallop > 1)
+        --min_gallop;
+    }
+  }
+  algs::copy(t, te, d);
+}
+
+/*!
+ * Merges the run [b,m) with the run held in buffer [t,te) that followed it,
+ * writing backward from e, galloping like merge_low
+ */
+template <class RandomIt, class T, class Compare>
+void merge_high(RandomIt b, RandomIt m, T *t, T *te, RandomIt e, Compare &c,
+                std::ptrdiff_t &min_gallop) {
+  not_after_compare<Compare> upper = {c};
+  while (b != m && t != te) {
+    std::ptrdiff_t wa = 0, wb = 0;
+    while (b != m && t != te && wa + wb < min_gallop) {
+      bool s = c(te[-1], m[-1]);
+      *--e = s ? m[-1] : te[-1];
+      m -= s;
+      te -= !s;
+      wa = (wa + 1) * s;
+      wb = (wb + 1) * !s;
+    }
+    while (b != m && t != te) {
+      RandomIt p = algs::exponential_lower_bound(b, m, m - 1, te[-1], upper);
+      wa = m - p;
+      while (m != p)
+        *--e = *--m;
+      if (b == m)
+        break;
+      T *q = algs::exponential_lower_bound(t, te, te - 1, m[-1], c);
+      wb = te - q;
+      while (te != q)
+        *--e = *--te;
+      if (wa < stable_sort_min_gallop && wb < stable_sort_min_gallop) {
+        min_gallop += 2;
+        break;
+      }
+      if (min_gallop > 1)
+        --min_gallop;
+    }
+  }
+  while (t != te)
+    *--e = *--te;
+}
+
+/*!
+ * Merges the adjacent sorted runs [b,m) and [m,e). The elements of the first
+ * run not after the first of the second, and those of the second not before
+ * the last of the first, are already in place and found by galloping; the
+ * shorter remaining run then moves to the buffer if it fits, and the merge
+ * falls back to inplace_merge otherwise.
+ */
+template <class RandomIt, class Compare, class T>
+void merge_runs(RandomIt b, RandomIt m, RandomIt e, Compare &c, T *buf,
+                std::ptrdiff_t len, std::ptrdiff_t &min_gallop) {
+  not_after_compare<Compare> upper = {c};
+  b = algs::exponential_lower_bound(b, m, b, *m, upper);
+  if (b == m)
+    return;
+  e = algs::exponential_lower_bound(m, e, e - 1, m[-1], c);
+  std::ptrdiff_t n1 = m - b, n2 = e - m;
+  if (n1 <= n2 && n1 <= len)
+    detail::merge_low(b, buf, algs::copy(b, m, buf), m, e, c, min_gallop);
+  else if (n2 < n1 && n2 <= len)
+    detail::merge_high(b, m, buf, algs::copy(m, e, buf), e, c, min_gallop);
+  else
+    detail::inplace_merge(b, m, e, c, n1, n2, buf, len);
+}
+
+/*!
+ * Natural merge sort of [b,e): runs found in the input, or extended to the
+ * minimum run length by insertion sort, are pushed on a stack and merged
+ * while the lengths of the topmost three do not shrink fast enough, so that
+ * merges stay balanced and the stack logarithmic
+ */
+template <class RandomIt, class Compare, class T>
+void stable_sort(RandomIt b, RandomIt e, Compare &c, T *buf,
+                 std::ptrdiff_t len) {
+  std::ptrdiff_t n = e - b;
+  if (n < 2)
+    return;
+  std::ptrdiff_t mr = detail::min_run(n), min_gallop = stable_sort_min_gallop;
+  std::vector<std::ptrdiff_t> runs(1, 0);
+  for (RandomIt it = b; it != e;) {
+    RandomIt r = detail::natural_run(it, e, c);
+    if (r - it < mr) {
+      r = e - it < mr ? e : it + mr;
+      detail::insertion_sort(it, r, c, false);
+    }
+    it = r;
+    runs.push_back(r - b);
+    // runs[i] is the offset where run i ends, and run i - 1 begins
+    for (std::size_t k = runs.size() - 1; k > 1; k = runs.size() - 1) {
+      std::ptrdiff_t z = runs[k] - runs[k - 1], y = runs[k - 1] - runs[k - 2];
+      std::ptrdiff_t x = k > 2 ? runs[k - 2] - runs[k - 3] : 0;
+      std::ptrdiff_t w = k > 3 ? runs[k - 3] - runs[k - 4] : 0;
+      if (y > z && (k < 3 || x > y + z) && (k < 4 || w > x + y))
+        break;
+      // merge y with the shorter of its neighbours
+      std::size_t j = k > 2 && x < z ? k - 1 : k;
+      detail::merge_runs(b + runs[j - 2], b + runs[j - 1], b + runs[j], c,
+                         buf, len, min_gallop);
+      runs.erase(runs.begin() + (j - 1));
+    }
+  }
+  while (runs.size() > 2) {
+    std::size_t k = runs.size() - 1;
+    detail::merge_runs(b + runs[k - 2], b + runs[k - 1], b + runs[k], c, buf,
+                       len, min_gallop);
+    runs.erase(runs.begin() + (k - 1));
+  }
+}
+
+} /* namespace detail */
+
+/*!
+ * Sorts the sequence [b,e) stably with an adaptive natural merge sort in the
+ * manner of TimSort. Ascending and strictly descending runs already in the
+ * input are used as they are, the latter reversed, so that presorted,
+ * appended or reversed data sorts in close to linear time, and merges gallop
+ * through long stretches taken from one side. Takes O(n log n) comparisons
+ * and a temporary buffer of n/2 elements, degrading to in-place merges when
+ * it cannot be allocated.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param c comparator function
+ */
+template <class RandomIt, class Compare>
+void stable_sort(RandomIt b, RandomIt e, Compare c) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  if (e - b < 2)
+    return;
+  detail::temporary_buffer<T> buf((e - b) / 2);
+  if (buf.size() > 0)
+    buf.fill(*b);
+  detail::stable_sort(b, e, c, buf.data(), buf.size());
+}
+
+/*!
+ * Sorts the sequence [b,e) stably in ascending order using operator<
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ */
+template <class RandomIt> void stable_sort(RandomIt b, RandomIt e) {
+  algs::stable_sort(b, e, detail::less());
+}
+
+/*!
+ * Sorts the sequence [b,e) stably as above, using a caller-owned scratch
+ * buffer instead of allocating one, so that repeated sorts need not allocate.
+ * A buffer of half as many elements as the range is always enough; a shorter
+ * one, or none, leaves the merges that do not fit to run in place.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param c comparator function
+ * @param buf pointer to len constructed elements that may be overwritten
+ * @param len number of elements in the scratch buffer
+ */
+template <class RandomIt, class Compare, class T>
+void stable_sort(RandomIt b, RandomIt e, Compare c, T *buf,
+                 std::ptrdiff_t len) {
+  detail::stable_sort(b, e, c, buf, len);
+}
+
+namespace detail {
+
+/*!
+ * Radix sort digits are bytes; ranges shorter than the cutoff are sorted by
+ * comparison instead, as the histograms would cost more than they save
+ */
+const int radix_size = 256;
+const std::ptrdiff_t radix_sort_cutoff = 256;
+
+/*!
+ * Bytes of data above which a radix sort splits the range on its most
+ * significant digit first, leaving buckets small enough to stay in cache for
+ * the remaining passes
+ */
+const std::ptrdiff_t radix_cache_bytes = 1 << 20;
+
+/*!
+ * Unsigned integer key of type U ordered like the integer x of type T: for
+ * signed types the sign bit is flipped, moving negative values below the rest
+ */
+template <class T, class U> struct radix_integer {
+  typedef U type;
+  static U key(T x) {
+    return U(U(x) ^ (T(-1) < T(0) ? U(1) << (8 * sizeof(U) - 1) : 0));
+  }
+};
+
+/*!
+ * Unsigned integer of the same size as T whose order matches that of T, for
+ * integral and IEEE floating point T. Floats have their sign bit set when
+ * positive and all bits flipped when negative, ordering -0.0 just before 0.0,
+ * positive NaNs after infinity and negative NaNs before minus infinity.
+ */
+template <class T, bool Integral = is_integral<T>::value,
+          std::size_t Size = sizeof(T)>
+struct radix_traits {};
+
+template <class T>
+struct radix_traits<T, true, 1> : radix_integer<T, unsigned char> {};
+
+template <class T>
+struct radix_traits<T, true, 2> : radix_integer<T, unsigned short> {};
+
+template <class T>
+struct radix_traits<T, true, 4> : radix_integer<T, unsigned> {};
+
+template <class T>
+struct radix_traits<T, true, 8> : radix_integer<T, unsigned long long> {};
+
+template <> struct radix_traits<float, false, 4> {
+  typedef unsigned type;
+  static unsigned key(float x) {
+    unsigned u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u ^ (-(u >> 31) | 0x80000000u);
+  }
+};
+
+template <> struct radix_traits<double, false, 8> {
+  typedef unsigned long long type;
+  static unsigned long long key(double x) {
+    unsigned long long u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u ^ (-(u >> 63) | 0x8000000000000000ull);
+  }
+};
+
+/*!
+ * Type of the keys returned by a key extractor: the result_type of a functor,
+ * or the return type of a function pointer, without const or reference
+ */
+template <class KeyFn> struct key_result {
+  typedef typename KeyFn::result_type type;
+};
+
+template <class R, class A> struct key_result<R (*)(A)> {
+  typedef R type;
+};
+
+template <class R, class A> struct key_result<const R &(*)(A)> {
+  typedef R type;
+};
+
+/*!
+ * Key extractor returning the element itself
+ */
+template <class T> struct identity {
+  typedef T result_type;
+
+  const T &operator()(const T &x) const { return x; }
+};
+
+/*!
+ * Key extractor composed with the order preserving transform of its keys
+ */
+template <class KeyFn> struct radix_key {
+  typedef typename remove_const<typename key_result<KeyFn>::type>::type K;
+  typedef typename radix_traits<K>::type type;
+  KeyFn f;
+
+  template <class T> type operator()(const T &x) {
+    return radix_traits<K>::key(f(x));
+  }
+};
+
+/*!
+ * Comparator ordering elements by their transformed keys, for the short
+ * ranges sorted by comparison
+ */
+template <class Key> struct radix_less {
+  Key key;
+
+  template <class T> bool operator()(const T &x, const T &y) {
+    return key(x) < key(y);
+  }
+};
+
+/*!
+ * Byte of the transformed key u at digit d, counting from the least
+ * significant
+ */
+template <class U> inline int radix_digit(U u, int d) {
+  return int((u >> (8 * d)) & 0xff);
+}
+
+/*!
+ * Stably moves the n elements at src to dst, each to the next free slot of
+ * the bucket of its byte at digit d, buckets starting at offset
+ */
+template <class Src, class Dst, class Key>
+void radix_scatter(Src src, std::ptrdiff_t n, Dst dst, Key &key, int d,
+                   std::ptrdiff_t *offset) {
+  for (Src e = src + n; src != e; ++src)
+    dst[offset[radix_digit(key(*src), d)]++] = *src;
+}
+
+/*!
+ * Sorts the n elements at src by the bytes of their keys below digit digits,
+ * using the n elements at dst as scratch, and leaves the result at dst when
+ * into_dst is set, else at src. Ranges too large for the cache get one most
+ * significant digit pass splitting them into buckets sorted recursively;
+ * the buckets, like ranges that fit to begin with, are then sorted by least
+ * significant digit passes while in cache. Digits on which all keys agree
+ * are skipped, which for the least significant digit passes one histogram
+ * of every digit reveals up front.
+ */
+template <class Src, class Dst, class Key>
+void radix_sort(Src src, Dst dst, std::ptrdiff_t n, Key &key, int digits,
+                bool into_dst) {
+  typedef typename std::iterator_traits<Src>::value_type T;
+  typedef typename Key::type U;
+  if (n < radix_sort_cutoff) {
+    radix_less<Key> less_key = {key};
+    algs::stable_sort(src, src + n, less_key);
+    if (into_dst)
+      algs::copy(src, src + n, dst);
+    return;
+  }
+  // a second row for 1-byte keys, whose most significant digit pass never
+  // runs, keeps compilers from flagging its indexing as out of bounds
+  std::ptrdiff_t count[sizeof(U) > 1 ? sizeof(U) : 2][radix_size] = {{0}};
+  std::ptrdiff_t offset[radix_size + 1];
+  U first = key(*src);
+  while (digits > 1 && n * std::ptrdiff_t(sizeof(T)) > radix_cache_bytes) {
+    int d = digits - 1;
+    for (Src it = src, e = src + n; it != e; ++it)
+      ++count[d][radix_digit(key(*it), d)];
+    --digits;
+    if (count[d][radix_digit(first, d)] == n)
+      continue;
+    offset[0] = 0;
+    for (int v = 0; v < radix_size; ++v)
+      offset[v + 1] = offset[v] + count[d][v];
+    std::ptrdiff_t start[radix_size + 1];
+    algs::copy(offset, offset + radix_size + 1, start);
+    radix_scatter(src, n, dst, key, d, offset);
+    for (int v = 0; v < radix_size; ++v)
+      if (start[v + 1] > start[v])
+        detail::radix_sort(dst + start[v], src + start[v],
+                           start[v + 1] - start[v], key, d, !into_dst);
+    return;
+  }
+  for (Src it = src, e = src + n; it != e; ++it) {
+    U u = key(*it);
+    for (int d = 0; d < digits; ++d)
+      ++count[d][radix_digit(u, d)];
+  }
+  bool in_dst = false;
+  for (int d = 0; d < digits; ++d) {
+    if (count[d][radix_digit(first, d)] == n)
+      continue;
+    offset[0] = 0;
+    for (int v = 1; v < radix_size; ++v)
+      offset[v] = offset[v - 1] + count[d][v - 1];
+    if (in_dst)
+      radix_scatter(dst, n, src, key, d, offset);
+    else
+      radix_scatter(src, n, dst, key, d, offset);
+    in_dst = !in_dst;
+  }
+  if (in_dst && !into_dst)
+    algs::copy(dst, dst + n, src);
+  else if (!in_dst && into_dst)
+    algs::copy(src, src + n, dst);
+}
+
+/*!
+ * Parallel task counting the bytes at digit d of the keys of chunk i
+ */
+template <class It, class Key> struct radix_histogram {
+  It b;
+  std::ptrdiff_t n, k;
+  Key key;
+  int d;
+  std::ptrdiff_t *count;
+
+  void operator()(std::ptrdiff_t i) const {
+    Key f = key;
+    std::ptrdiff_t *c = count + i * radix_size;
+    for (int v = 0; v < radix_size; ++v)
+      c[v] = 0;
+    It ce = b + chunk_begin(n, k, i + 1);
+    for (It it = b + chunk_begin(n, k, i); it != ce; ++it)
+      ++c[radix_digit(f(*it), d)];
+  }
+};
+
+/*!
+ * Parallel task scattering chunk i of [b,b+n) to d on digit d, into the
+ * bucket slots reserved for the chunk
+ */
+template <class Src, class Dst, class Key> struct radix_chunk {
+  Src b;
+  Dst dst;
+  std::ptrdiff_t n, k;
+  Key key;
+  int d;
+  std::ptrdiff_t *offset;
+
+  void operator()(std::ptrdiff_t i) const {
+    Key f = key;
+    std::ptrdiff_t cb = chunk_begin(n, k, i);
+    radix_scatter(b + cb, chunk_begin(n, k, i + 1) - cb, dst, f, d,
+                  offset + i * radix_size);
+  }
+};
+
+/*!
+ * Bucket left by the parallel splits of a radix sort: n elements from start,
+ * in the buffer or in the range, still to be sorted on the bytes of their
+ * keys below digit digits
+ */
+struct radix_part {
+  std::ptrdiff_t start, n;
+  int digits;
+  bool in_buf;
+};
+
+/*!
+ * Orders radix_part by decreasing size
+ */
+struct radix_part_larger {
+  bool operator()(const radix_part &x, const radix_part &y) const {
+    return x.n > y.n;
+  }
+};
+
+/*!
+ * Parallel task sorting part j of the splits made by the parallel radix sort
+ * into its final place in the range
+ */
+template <class RandomIt, class T, class Key> struct radix_bucket {
+  T *buf;
+  RandomIt b;
+  Key key;
+  const radix_part *parts;
+
+  void operator()(std::ptrdiff_t j) const {
+    Key f = key;
+    radix_part p = parts[j];
+    if (p.in_buf)
+      detail::radix_sort(buf + p.start, b + p.start, p.n, f, p.digits, true);
+    else
+      detail::radix_sort(b + p.start, buf + p.start, p.n, f, p.digits, false);
+  }
+};
+
+/*!
+ * Counts the bytes at digit d of the n elements at src with k threads, into
+ * one row of count per chunk, and returns how many share the byte of the
+ * first element
+ */
+template <class Src, class Key>
+std::ptrdiff_t radix_count(Src src, std::ptrdiff_t n, Key &key, int d,
+                           std::ptrdiff_t k, std::ptrdiff_t *count) {
+  radix_histogram<Src, Key> hist = {src, n, k, key, d, count};
+  parallel_for(k, hist);
+  int v0 = radix_digit(key(*src), d);
+  std::ptrdiff_t same = 0;
+  for (std::ptrdiff_t i = 0; i < k; ++i)
+    same += count[i * radix_size + v0];
+  return same;
+}
+
+/*!
+ * Splits part p on the most significant byte where its keys differ, with k
+ * threads moving it between the range and the buffer, and appends the
+ * buckets to parts; buckets larger than large are split again the same way,
+ * so that every thread finds buckets to sort
+ */
+template <class RandomIt, class T, class Key>
+void radix_split(RandomIt b, T *buf, radix_part p, Key &key, std::ptrdiff_t k,
+                 std::ptrdiff_t large, std::vector<radix_part> &parts) {
+  std::vector<std::ptrdiff_t> count(k * radix_size), offset(k * radix_size);
+  std::vector<std::ptrdiff_t> start(radix_size + 1);
+  std::ptrdiff_t same = p.n;
+  while (same == p.n && p.digits > 0) {
+    --p.digits;
+    same = p.in_buf
+               ? radix_count(buf + p.start, p.n, key, p.digits, k, &count[0])
+               : radix_count(b + p.start, p.n, key, p.digits, k, &count[0]);
+  }
+  if (same == p.n) {
+    // equal keys: only a part in the buffer has anything left to do
+    if (p.in_buf)
+      parts.push_back(p);
+    return;
+  }
+  std::ptrdiff_t sum = 0;
+  for (int v = 0; v < radix_size; ++v) {
+    start[v] = sum;
+    for (std::ptrdiff_t i = 0; i < k; ++i) {
+      offset[i * radix_size + v] = sum;
+      sum += count[i * radix_size + v];
+    }
+  }
+  start[radix_size] = p.n;
+  if (p.in_buf) {
+    radix_chunk<T *, RandomIt, Key> scatter = {
+        buf + p.start, b + p.start, p.n, k, key, p.digits, &offset[0]};
+    parallel_for(k, scatter);
+  } else {
+    radix_chunk<RandomIt, T *, Key> scatter = {
+        b + p.start, buf + p.start, p.n, k, key, p.digits, &offset[0]};
+    parallel_for(k, scatter);
+  }
+  for (int v = 0; v < radix_size; ++v) {
+    radix_part q = {p.start + start[v], start[v + 1] - start[v], p.digits,
+                    !p.in_buf};
+    if (q.n > large && q.digits > 0)
+      radix_split(b, buf, q, key, k, large, parts);
+    else if (q.n > 0)
+      parts.push_back(q);
+  }
+}
+
+/*!
+ * Radix sort of [b,e) with k threads. The most significant byte where the
+ * keys differ splits the range into buckets in one parallel pass: every
+ * chunk of the range counts its bytes, a prefix sum gives every chunk its
+ * own slots in each bucket, and the chunks are scattered independently.
+ * Buckets holding more than a thread's share are split again on the next
+ * byte. The buckets are then sorted in parallel by the serial radix sort,
+ * largest first, handed out to the threads as they become free.
+ */
+template <class RandomIt, class Key>
+void radix_sort(RandomIt b, RandomIt e, Key key, std::ptrdiff_t k) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  std::ptrdiff_t n = e - b;
+  int digits = sizeof(typename Key::type);
+  radix_less<Key> less_key = {key};
+  if (n < radix_sort_cutoff) {
+    algs::stable_sort(b, e, less_key);
+    return;
+  }
+  temporary_buffer<T> buf(n);
+  if (buf.size() < n) {
+    algs::stable_sort(b, e, less_key);
+    return;
+  }
+  buf.fill(*b);
+  if (k == 1) {
+    detail::radix_sort(b, buf.data(), n, key, digits, false);
+    return;
+  }
+  radix_part whole = {0, n, digits, false};
+  std::vector<radix_part> parts;
+  radix_split(b, buf.data(), whole, key, k, n / k, parts);
+  if (parts.empty())
+    return;
+  algs::sort(parts.begin(), parts.end(), radix_part_larger());
+  radix_bucket<RandomIt, T, Key> sort = {buf.data(), b, key, &parts[0]};
+  parallel_for_dynamic(std::ptrdiff_t(parts.size()), sort);
+}
+
+} /* namespace detail */
+
+/*!
+ * Sorts the sequence [b,e) of integers or IEEE floating point numbers in
+ * ascending order with a hybrid radix sort. Ranges larger than the cache are
+ * first split into buckets by most significant digit passes, and the buckets,
+ * like ranges that fit in the cache, are then sorted by least significant
+ * digit passes, one counting pass per byte and none for bytes on which all
+ * values agree. Takes linear time and a temporary buffer as long as the range,
+ * and falls back to stable_sort when it cannot be allocated. Floats are ordered by
+ * their bits: -0.0 before 0.0, and NaNs at the ends by their sign.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ */
+template <class RandomIt> void radix_sort(RandomIt b, RandomIt e) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  detail::radix_key<detail::identity<T> > key = {detail::identity<T>()};
+  detail::radix_sort(b, e, key, 1);
+}
+
+/*!
+ * Sorts the sequence [b,e) stably by the integer or floating point keys that
+ * key extracts from its elements, with the radix sort above; each element is
+ * moved once per pass and its key extracted once per pass
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param key key extractor: a function pointer, or a functor defining
+ * result_type, returning an arithmetic key
+ */
+template <class RandomIt, class KeyFn>
+void radix_sort(RandomIt b, RandomIt e, KeyFn key) {
+  detail::radix_key<KeyFn> k = {key};
+  detail::radix_sort(b, e, k, 1);
+}
+
+/*!
+ * Parallel version of radix_sort. One parallel pass splits the range on the
+ * most significant byte where the values differ: the threads count the bytes
+ * of their chunk of the range, a prefix sum over the counts gives every chunk
+ * its own slots in each bucket, and the threads then scatter their chunks
+ * independently. Buckets holding more than a thread's share are split again
+ * the same way on the next byte. The buckets are then sorted in parallel by
+ * the serial radix sort, each by one thread.
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ */
+template <class RandomIt>
+void radix_sort(const parallel_policy &, RandomIt b, RandomIt e) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+  detail::radix_key<detail::identity<T> > key = {detail::identity<T>()};
+  detail::radix_sort(b, e, key, detail::chunk_count(e - b));
+}
+
+/*!
+ * Parallel version of radix_sort with a key extractor
+ *
+ * @param b random access iter marking the beginning of the sequence
+ * @param e random access iter marking the end of the sequence
+ * @param key key extractor: a function pointer, or a functor defining
+ * result_type, returning an arithmetic key
+ */
+template <class RandomIt, class KeyFn>
+void radix_sort(const parallel_policy &, RandomIt b, RandomIt e, KeyFn key) {
+  detail::radix_key<KeyFn> k = {key};
+  detail::radix_sort(b, e, k, detail::chunk_count(e - b));
+}
+
+/*!
+ * Merges any number of sorted input ranges through a loser tree: a complete
+ * binary tournament over the ranges whose inner nodes keep the loser of the
+ * match played there, so that replacing the winner takes one comparison per
+ * level on the path up from its leaf, log K in all, with none of the sibling
+ * comparisons of a binary heap. The current element of every range is cached
+ * in one contiguous array, keeping each replay within a few cache lines
+ * instead of touching K different ranges. Equivalent elements come out in
+ * the order of their ranges, so the merge is stable.
+ */
+template <class InputIt, class Compare = detail::less> class kway_merger {
+public:
+  typedef typename std::iterator_traits<InputIt>::value_type value_type;
+
+  /*!
+   * Starts merging the ranges in [rb,re)
+   *
+   * @param rb input iter marking the beginning of a sequence of
+   * std::pair<InputIt, InputIt> delimiting sorted ranges
+   * @param re input iter marking the end of the sequence of ranges
+   * @param c comparator function every range is sorted by
+   */
+  template <class RangeIt>
+  kway_merger(RangeIt rb, RangeIt re, Compare c = Compare())
+      : leaves(1), comp(c) {
+    for (; rb != re; ++rb) {
+      cur.push_back((*rb).first);
+      end.push_back((*rb).second);
+    }
+    std::size_t k = cur.size();
+    while (leaves < k)
+      leaves *= 2;
+    done.assign(leaves, 1);
+    for (std::size_t i = 0; i < k; ++i) {
+      if (cur[i] == end[i])
+        continue;
+      done[i] = 0;
+      if (head.empty())
+        head.assign(k, *cur[i]);
+      else
+        head[i] = *cur[i];
+    }
+    build();
+  }
+
+  /*!
+   * @returns true once every range has been consumed
+   */
+  bool empty() const { return done[tree[0]] != 0; }
+
+  /*!
+   * @returns the least remaining element, which must exist
+   */
+  const value_type &top() const { return head[tree[0]]; }
+
+  /*!
+   * Consumes the least remaining element, which must exist
+   */
+  void pop() {
+    std::size_t w = tree[0];
+    if (++cur[w] != end[w])
+      head[w] = *cur[w];
+    else
+      done[w] = 1;
+    replay(w);
+  }
+
+  /*!
+   * Writes the remaining elements in order to d, which may be a streaming
+   * output iterator feeding the next stage
+   *
+   * @param d output iter marking the beginning of the destination
+   *
+   * @returns output iter marking the end of the destination
+   */
+  template <class OutputIt> OutputIt copy(OutputIt d) {
+    for (; !empty(); ++d) {
+      *d = top();
+      pop();
+    }
+    return d;
+  }
+
+private:
+  // Tells whether range i wins its match against range j, the ranges that
+  // come first winning ties; exhausted ranges, including the padding up to a
+  // power of two, lose every match
+  bool beats(std::size_t i, std::size_t j) {
+    if (done[i] | done[j])
+      return !done[i];
+    bool first = i < j;
+    const value_type &x = head[first ? j : i], &y = head[first ? i : j];
+    return comp(x, y) != first;
+  }
+
+  void build() {
+    std::vector<std::size_t> winner(2 * leaves);
+    tree.assign(leaves, 0);
+    for (std::size_t i = 0; i < leaves; ++i)
+      winner[leaves + i] = i;
+    for (std::size_t n = leaves - 1; n > 0; --n) {
+      std::size_t l = winner[2 * n], r = winner[2 * n + 1];
+      bool left = beats(l, r);
+      winner[n] = left ? l : r;
+      tree[n] = left ? r : l;
+    }
+    tree[0] = winner[1];
+  }
+
+  // Plays the matches on the path from leaf w to the root again
+  void replay(std::size_t w) {
+    for (std::size_t n = (leaves + w) / 2; n > 0; n /= 2) {
+      // the loser stays, the winner moves up: exchanged with a mask since
+      // a select here compiles to a branch mispredicted half of the time
+      std::size_t l = tree[n];
+      std::size_t flip = (l ^ w) & (std::size_t(0) - beats(l, w));
+      tree[n] = l ^ flip;
+      w ^= flip;
+    }
+    tree[0] = w;
+  }
+
+  std::size_t leaves;
+  Compare comp;
+  std::vector<InputIt> cur, end;
+  std::vector<value_type> head;
+  std::vector<char> done;
+  std::vector<std::size_t> tree;
+};
+
+/*!
+ * Merges the sorted ranges delimited by the pairs of iterators in [rb,re)
+ * into d with a loser tree, stably, in O(n log K) comparisons for n elements
+ * in K ranges and a single pass over the data
+ *
+ * @param rb input iter marking the beginning of a sequence of std::pair of
+ * input iters delimiting sorted ranges
+ * @param re input iter marking the end of the sequence of ranges
+ * @param d output iter marking the beginning of the destination
+ * @param c comparator function every range is sorted by
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class RangeIt, class OutputIt, class Compare>
+OutputIt multiway_merge(RangeIt rb, RangeIt re, OutputIt d, Compare c) {
+  typedef typename std::iterator_traits<RangeIt>::value_type::first_type It;
+  kway_merger<It, Compare> m(rb, re, c);
+  return m.copy(d);
+}
+
+/*!
+ * Merges the sorted ranges delimited by the pairs of iterators in [rb,re)
+ * into d, compared with operator<
+ *
+ * @param rb input iter marking the beginning of a sequence of std::pair of
+ * input iters delimiting sorted ranges
+ * @param re input iter marking the end of the sequence of ranges
+ * @param d output iter marking the beginning of the destination
+ *
+ * @returns output iter marking the end of the destination
+ */
+template <class RangeIt, class OutputIt>
+OutputIt multiway_merge(RangeIt rb, RangeIt re, OutputIt d) {
+  return algs::multiway_merge(rb, re, d, detail::less());
 }
 
 /*!
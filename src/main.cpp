@@ -61,16 +61,136 @@ int main() {
   test_remove_if();
   destroy_test();
 
+  std::cout << "Testing the parallel remove_if() function..." << std::endl;
+  initialize_test();
+  test_parallel_remove_if();
+  destroy_test();
+
+  std::cout << "Testing the unstable_remove() function..." << std::endl;
+  initialize_test();
+  test_unstable_remove();
+  destroy_test();
+
+  std::cout << "Testing the unstable_remove_if() function..." << std::endl;
+  initialize_test();
+  test_unstable_remove_if();
+  destroy_test();
+
+  std::cout << "Testing the erase_if() function..." << std::endl;
+  initialize_test();
+  test_erase_if();
+  destroy_test();
+
+  std::cout << "Testing the erase() function..." << std::endl;
+  initialize_test();
+  test_erase();
+  destroy_test();
+
+  std::cout << "Testing the replace() function..." << std::endl;
+  initialize_test();
+  test_replace();
+  destroy_test();
+
+  std::cout << "Testing the replace_if() function..." << std::endl;
+  initialize_test();
+  test_replace_if();
+  destroy_test();
+
+  std::cout << "Testing the replace_copy() function..." << std::endl;
+  initialize_test();
+  test_replace_copy();
+  destroy_test();
+
+  std::cout << "Testing the replace_copy_if() function..." << std::endl;
+  initialize_test();
+  test_replace_copy_if();
+  destroy_test();
+
+  std::cout << "Testing the translate() function..." << std::endl;
+  initialize_test();
+  test_translate();
+  destroy_test();
+
   std::cout << "Testing the partition() function..." << std::endl;
   initialize_test();
   test_partition() ;
   destroy_test();
 
+  std::cout << "Testing the parallel partition() function..." << std::endl;
+  initialize_test();
+  test_parallel_partition();
+  destroy_test();
+
   std::cout << "Testing the reverse() function..." << std::endl;
   initialize_test();
   test_reverse();
   destroy_test();
 
+  std::cout << "Testing the rotate() function..." << std::endl;
+  initialize_test();
+  test_rotate();
+  destroy_test();
+
+  std::cout << "Testing the stable_partition() function..." << std::endl;
+  initialize_test();
+  test_stable_partition();
+  destroy_test();
+
+  std::cout << "Testing the three_way_partition() function..." << std::endl;
+  initialize_test();
+  test_three_way_partition();
+  destroy_test();
+
+  std::cout << "Testing the bucket_partition() function..." << std::endl;
+  initialize_test();
+  test_bucket_partition();
+  destroy_test();
+
+  std::cout << "Testing the sort() function..." << std::endl;
+  initialize_test();
+  test_sort();
+  destroy_test();
+
+  std::cout << "Testing the parallel sort() function..." << std::endl;
+  initialize_test();
+  test_parallel_sort();
+  destroy_test();
+
+  std::cout << "Testing the stable_sort() function..." << std::endl;
+  initialize_test();
+  test_stable_sort();
+  destroy_test();
+
+  std::cout << "Testing the radix_sort() function..." << std::endl;
+  initialize_test();
+  test_radix_sort();
+  destroy_test();
+
+  std::cout << "Testing the parallel radix_sort() function..." << std::endl;
+  initialize_test();
+  test_parallel_radix_sort();
+  destroy_test();
+
+  std::cout << "Testing the sort_small() function..." << std::endl;
+  initialize_test();
+  test_sort_small();
+  destroy_test();
+
+  std::cout << "Testing the nth_element() function..." << std::endl;
+  initialize_test();
+  test_nth_element();
+  destroy_test();
+
+  std::cout << "Testing the partial_sort() function..." << std::endl;
+  initialize_test();
+  test_partial_sort();
+  destroy_test();
+
+  std::cout << "Testing the partial_sort_copy() function..." << std::endl;
+  initialize_test();
+  test_partial_sort_copy();
+  destroy_test();
+
   std::cout << "Testing the accumulate() function..." << std::endl;
   initialize_test();
   test_accumulate();
@@ -86,6 +206,106 @@ int main() {
   test_binary_search();
   destroy_test();
 
+  std::cout << "Testing the partition_point() function..." << std::endl;
+  initialize_test();
+  test_partition_point();
+  destroy_test();
+
+  std::cout << "Testing the lower_bound() function..." << std::endl;
+  initialize_test();
+  test_lower_bound();
+  destroy_test();
+
+  std::cout << "Testing the upper_bound() function..." << std::endl;
+  initialize_test();
+  test_upper_bound();
+  destroy_test();
+
+  std::cout << "Testing the equal_range() function..." << std::endl;
+  initialize_test();
+  test_equal_range();
+  destroy_test();
+
+  std::cout << "Testing the lower_bound_batch() function..." << std::endl;
+  initialize_test();
+  test_lower_bound_batch();
+  destroy_test();
+
+  std::cout << "Testing the binary_search_batch() function..." << std::endl;
+  initialize_test();
+  test_binary_search_batch();
+  destroy_test();
+
+  std::cout << "Testing the interpolation_search() function..." << std::endl;
+  initialize_test();
+  test_interpolation_search();
+  destroy_test();
+
+  std::cout << "Testing the exponential_search() function..." << std::endl;
+  initialize_test();
+  test_exponential_search();
+  destroy_test();
+
+  std::cout << "Testing the learned_index class..." << std::endl;
+  initialize_test();
+  test_learned_index();
+  destroy_test();
+
+  std::cout << "Testing the set_intersection() function..." << std::endl;
+  initialize_test();
+  test_set_intersection();
+  destroy_test();
+
+  std::cout << "Testing the set_union() function..." << std::endl;
+  initialize_test();
+  test_set_union();
+  destroy_test();
+
+  std::cout << "Testing the set_difference() function..." << std::endl;
+  initialize_test();
+  test_set_difference();
+  destroy_test();
+
+  std::cout << "Testing the includes() function..." << std::endl;
+  initialize_test();
+  test_includes();
+  destroy_test();
+
+  std::cout << "Testing the merge() function..." << std::endl;
+  initialize_test();
+  test_merge();
+  destroy_test();
+
+  std::cout << "Testing the parallel merge() function..." << std::endl;
+  initialize_test();
+  test_parallel_merge();
+  destroy_test();
+
+  std::cout << "Testing the inplace_merge() function..." << std::endl;
+  initialize_test();
+  test_inplace_merge();
+  destroy_test();
+
+  std::cout << "Testing the multiway_merge() function..." << std::endl;
+  initialize_test();
+  test_multiway_merge();
+  destroy_test();
+
+  std::cout << "Testing the kway_merger class..." << std::endl;
+  initialize_test();
+  test_kway_merger();
+  destroy_test();
+
+  std::cout << "Testing the eytzinger_index class..." << std::endl;
+  initialize_test();
+  test_eytzinger_index();
+  destroy_test();
+
+  std::cout << "Testing the static_btree class..." << std::endl;
+  initialize_test();
+  test_static_btree();
+  destroy_test();
+
   std::cout << "Testing the swap() function..." << std::endl;
   initialize_test();
   test_swap();
@@ -8,7 +8,12 @@
 #include "algs.h"
 #include <algorithm>
 #include <assert.h>
+#include <cstring>
+#include <deque>
 #include <iterator>
+#include <limits>
+#include <list>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -112,12 +117,792 @@ void test_remove() {}
 // TODO: Implement
 void test_remove_if() {}
 
-// TODO: Implement
-void test_partition() {}
+bool is_multiple_of_seven(int x) { return x % 7 == 0; }
+
+void test_parallel_remove_if() {
+  std::vector<int> big_algs, big_std;
+  for (int i = 0; i < 200000; i++)
+    big_algs.push_back((i * 37) % 1000);
+  big_std = big_algs;
+  vec_iter res_algs = algs::remove_if(algs::par, big_algs.begin(),
+                                      big_algs.end(), is_multiple_of_seven);
+  vec_iter res_std =
+      std::remove_if(big_std.begin(), big_std.end(), is_multiple_of_seven);
+  assert(res_algs - big_algs.begin() == res_std - big_std.begin());
+  assert(std::equal(big_algs.begin(), res_algs, big_std.begin()));
+  // nothing removed, and everything removed
+  res_algs = algs::remove_if(algs::par, big_algs.begin(), res_algs,
+                             is_multiple_of_seven);
+  assert(res_algs - big_algs.begin() == res_std - big_std.begin());
+  res_algs = algs::remove_if(algs::par, v6.begin(), v6.end(), is_even);
+  assert(res_algs == v6.begin());
+}
+
+void test_unstable_remove() {
+  const int &target = 4;
+  v1.push_back(target);
+  v2 = v1;
+  vec_iter res_algs = algs::unstable_remove(v1.begin(), v1.end(), target);
+  vec_iter res_std = std::remove(v2.begin(), v2.end(), target);
+  assert(res_algs - v1.begin() == res_std - v2.begin());
+  std::sort(v1.begin(), res_algs);
+  assert(std::equal(v1.begin(), res_algs, v2.begin()));
+  res_algs = algs::unstable_remove(v6.begin(), v6.end(), 0);
+  assert(res_algs == v6.begin());
+}
+
+void test_unstable_remove_if() {
+  vec_iter res_algs = algs::unstable_remove_if(v1.begin(), v1.end(), is_even);
+  vec_iter res_std = std::remove_if(v2.begin(), v2.end(), is_even);
+  assert(res_algs - v1.begin() == res_std - v2.begin());
+  std::sort(v1.begin(), res_algs);
+  assert(std::equal(v1.begin(), res_algs, v2.begin()));
+  // the holes are filled from the back, so the odd prefix is untouched
+  v4.push_back(2);
+  res_algs = algs::unstable_remove_if(v4.begin(), v4.end(), is_even);
+  assert(res_algs == v4.end() - 1);
+  assert(v4.front() == 1 && v4[9] == 19);
+}
+
+bool is_small(int x) { return x < 3; }
+
+bool is_large(int x) { return x > 6; }
+
+void test_erase_if() {
+  assert(algs::erase_if(v1, is_even) == 5);
+  assert(v1.size() == 5 && v1.front() == 1 && v1.back() == 9);
+  std::list<int> l(v2.begin(), v2.end());
+  assert(algs::erase_if(l, is_odd) == 5);
+  assert(l.size() == 5 && l.front() == 0 && l.back() == 8);
+  // erased elements near the front are compacted toward the back and
+  // erased elements near the back are compacted toward the front
+  std::deque<int> front(v2.begin(), v2.end()), back(v2.begin(), v2.end());
+  assert(algs::erase_if(front, is_small) == 3);
+  assert(std::equal(front.begin(), front.end(), v2.begin() + 3));
+  assert(algs::erase_if(back, is_large) == 3);
+  assert(std::equal(back.begin(), back.end(), v2.begin()));
+  std::deque<int> middle(v2.begin(), v2.end());
+  assert(algs::erase_if(middle, is_odd) == 5);
+  assert(std::equal(middle.begin(), middle.end(), v5.begin()));
+  assert(algs::erase_if(middle, is_odd) == 0);
+#if __cplusplus >= 201103L
+  std::forward_list<int> fl(v2.begin(), v2.end());
+  assert(algs::erase_if(fl, is_even) == 5);
+  assert(std::equal(fl.begin(), fl.end(), v4.begin()));
+#endif
+}
+
+void test_erase() {
+  assert(algs::erase(v6, 0) == 21);
+  assert(v6.empty());
+  std::list<int> l(v3.begin(), v3.end());
+  assert(algs::erase(l, 10) == 1);
+  assert(l.front() == 9);
+  std::deque<int> d(v1.begin(), v1.end());
+  assert(algs::erase(d, 7) == 1);
+  assert(d.size() == 9 && d[7] == 8);
+}
+
+bool is_nan(double x) { return x != x; }
+
+void test_replace() {
+  const int &target = 0;
+  std::vector<int> v6_std = v6;
+  v6[20] = 1;
+  v6_std[20] = 1;
+  algs::replace(v6.begin(), v6.end(), target, 7);
+  std::replace(v6_std.begin(), v6_std.end(), target, 7);
+  assert(v6 == v6_std);
+  std::string str_algs = "the quick brown fox jumps over the lazy dog";
+  std::string str_std = str_algs;
+  algs::replace(str_algs.begin(), str_algs.end(), ' ', '_');
+  std::replace(str_std.begin(), str_std.end(), ' ', '_');
+  assert(str_algs == str_std);
+  std::list<int> l(v3.begin(), v3.end());
+  algs::replace(l.begin(), l.end(), 10, 0);
+  assert(l.front() == 0);
+  std::vector<long> longs(v1.begin(), v1.end());
+  algs::replace(longs.begin(), longs.end(), 9L, -1L);
+  assert(longs[8] == 8 && longs[9] == -1);
+  std::vector<long long> wide(v1.begin(), v1.end());
+  wide[3] = -(1LL << 40);
+  algs::replace(wide.begin(), wide.end(), -(1LL << 40), 1LL << 40);
+  assert(wide[3] == 1LL << 40 && wide[4] == 4);
+}
+
+void test_replace_if() {
+  std::vector<double> d;
+  for (int i = 0; i < 21; i++)
+    d.push_back(i % 3 ? i : std::numeric_limits<double>::quiet_NaN());
+  algs::replace_if(d.begin(), d.end(), is_nan, -1.0);
+  for (int i = 0; i < 21; i++)
+    assert(d[i] == (i % 3 ? i : -1.0));
+  algs::replace_if(v1.begin(), v1.end(), is_even, 0);
+  assert(v1[2] == 0 && v1[3] == 3);
+}
+
+void test_replace_copy() {
+  std::vector<float> f(v1.begin(), v1.end());
+  std::vector<float> f_algs(f.size()), f_std(f.size());
+  algs::replace_copy(f.begin(), f.end(), f_algs.begin(), 3.0f, 0.5f);
+  std::replace_copy(f.begin(), f.end(), f_std.begin(), 3.0f, 0.5f);
+  assert(f_algs == f_std);
+  std::vector<short> s_algs;
+  algs::replace_copy(v5.begin(), v5.end(), std::back_inserter(s_algs), 4, 5);
+  assert(s_algs.size() == v5.size() && s_algs[2] == 5 && s_algs[3] == 6);
+}
+
+void test_replace_copy_if() {
+  std::vector<int> res_algs(v2.size()), res_std(v2.size());
+  vec_iter end_algs = algs::replace_copy_if(v2.begin(), v2.end(),
+                                            res_algs.begin(), is_odd, -1);
+  std::replace_copy_if(v2.begin(), v2.end(), res_std.begin(), is_odd, -1);
+  assert(end_algs == res_algs.end());
+  assert(res_algs == res_std);
+}
+
+void test_translate() {
+  std::string text;
+  for (int i = 0; i < 8; i++)
+    text += "The Quick Brown Fox, Jumps Over The Lazy Dog!\t\n";
+  std::string res_algs = text, res_std = text;
+  // lower case letters, and chained mappings compose like replace calls
+  algs::translation_table t;
+  for (char c = 'A'; c <= 'Z'; c++) {
+    t.replace(c, c - 'A' + 'a');
+    std::replace(res_std.begin(), res_std.end(), c, char(c - 'A' + 'a'));
+  }
+  t.replace('\t', ' ');
+  t.replace(' ', '_');
+  std::replace(res_std.begin(), res_std.end(), '\t', ' ');
+  std::replace(res_std.begin(), res_std.end(), ' ', '_');
+  algs::translate(res_algs.begin(), res_algs.end(), t);
+  assert(res_algs == res_std);
+  // a table differing from the identity everywhere
+  algs::translation_table inverse;
+  for (int i = 0; i < 256; i++)
+    inverse.set(i, 255 - i);
+  std::vector<unsigned char> bytes(text.begin(), text.end());
+  algs::translate(bytes.begin(), bytes.end(), inverse);
+  for (std::size_t i = 0; i < bytes.size(); i++)
+    assert(bytes[i] == 255 - (unsigned char)text[i]);
+  std::list<char> l(text.begin(), text.end());
+  algs::translate(l.begin(), l.end(), t);
+  assert(std::equal(l.begin(), l.end(), res_std.begin()));
+}
+
+// checks that [b,m) satisfies p and [m,e) does not
+template <class It, class Pred> bool is_partitioned_at(It b, It m, It e, Pred p) {
+  for (; b != m; ++b)
+    if (!p(*b))
+      return false;
+  for (; m != e; ++m)
+    if (p(*m))
+      return false;
+  return true;
+}
+
+void test_partition() {
+  vec_iter res_algs = algs::partition(v1.begin(), v1.end(), is_even);
+  assert(res_algs - v1.begin() == 5);
+  assert(is_partitioned_at(v1.begin(), res_algs, v1.end(), is_even));
+  std::list<int> l(v2.begin(), v2.end());
+  std::list<int>::iterator res_list = algs::partition(l.begin(), l.end(), is_odd);
+  assert(std::distance(l.begin(), res_list) == 5);
+  assert(is_partitioned_at(l.begin(), res_list, l.end(), is_odd));
+  // large enough for the block partition, with skewed predicate outcomes
+  std::vector<int> big;
+  for (int i = 0; i < 5000; i++)
+    big.push_back((i * 7919) % 1009);
+  std::vector<int> big_sorted = big;
+  std::sort(big_sorted.begin(), big_sorted.end());
+  res_algs = algs::partition(big.begin(), big.end(), is_multiple_of_seven);
+  assert(is_partitioned_at(big.begin(), res_algs, big.end(),
+                           is_multiple_of_seven));
+  res_algs = algs::partition(big.begin(), big.end(), is_odd);
+  assert(is_partitioned_at(big.begin(), res_algs, big.end(), is_odd));
+  std::sort(big.begin(), big.end());
+  assert(big == big_sorted);
+  assert(algs::partition(v6.begin(), v6.end(), is_odd) == v6.begin());
+  assert(algs::partition(v6.begin(), v6.end(), is_even) == v6.end());
+}
+
+void test_parallel_partition() {
+  std::vector<int> big;
+  for (int i = 0; i < 300000; i++)
+    big.push_back(int(i * 7919L % 100003));
+  std::vector<int> big_sorted = big;
+  std::sort(big_sorted.begin(), big_sorted.end());
+  vec_iter res_algs =
+      algs::partition(algs::par, big.begin(), big.end(), is_multiple_of_seven);
+  assert(res_algs - big.begin() ==
+         std::count_if(big.begin(), big.end(), is_multiple_of_seven));
+  assert(is_partitioned_at(big.begin(), res_algs, big.end(),
+                           is_multiple_of_seven));
+  res_algs = algs::partition(algs::par, big.begin(), big.end(), is_even);
+  assert(is_partitioned_at(big.begin(), res_algs, big.end(), is_even));
+  std::sort(big.begin(), big.end());
+  assert(big == big_sorted);
+  assert(algs::partition(algs::par, v1.begin(), v1.end(), is_odd) ==
+         v1.begin() + 5);
+}
 
 // TODO: Implement
 void test_reverse() {}
 
+void test_rotate() {
+  for (int m = 0; m <= 10; m++) {
+    std::vector<int> res_algs = v1, res_std = v1;
+    vec_iter pos = algs::rotate(res_algs.begin(), res_algs.begin() + m,
+                                res_algs.end());
+    std::rotate(res_std.begin(), res_std.begin() + m, res_std.end());
+    assert(res_algs == res_std);
+    assert(pos == (m == 0 ? res_algs.end() : res_algs.begin() + (10 - m)));
+  }
+  std::list<int> l(v1.begin(), v1.end());
+  std::list<int>::iterator m = l.begin();
+  std::advance(m, 3);
+  assert(*algs::rotate(l.begin(), m, l.end()) == 0);
+  assert(l.front() == 3 && l.back() == 2);
+}
+
+void test_stable_partition() {
+  std::vector<int> big;
+  for (int i = 0; i < 5000; i++)
+    big.push_back(int(i * 7919L % 1009));
+  std::vector<int> res_std = big;
+  std::stable_partition(res_std.begin(), res_std.end(), is_multiple_of_seven);
+  std::vector<int> res_algs = big;
+  vec_iter m = algs::stable_partition(res_algs.begin(), res_algs.end(),
+                                      is_multiple_of_seven);
+  assert(res_algs == res_std);
+  assert(m - res_algs.begin() == std::count_if(big.begin(), big.end(),
+                                               is_multiple_of_seven));
+  // caller-owned scratch too small for the range, and no scratch at all
+  std::vector<int> scratch(100);
+  res_algs = big;
+  algs::stable_partition(res_algs.begin(), res_algs.end(), is_multiple_of_seven,
+                         &scratch[0], (std::ptrdiff_t)scratch.size());
+  assert(res_algs == res_std);
+  res_algs = big;
+  algs::stable_partition(res_algs.begin(), res_algs.end(), is_multiple_of_seven,
+                         (int *)0, 0);
+  assert(res_algs == res_std);
+  std::list<int> l(v2.begin(), v2.end());
+  std::list<int>::iterator lm = algs::stable_partition(l.begin(), l.end(), is_odd);
+  assert(*lm == 0 && l.front() == 1 && l.back() == 8);
+  assert(algs::stable_partition(v6.begin(), v6.end(), is_even) == v6.end());
+}
+
+bool greater(int x, int y) { return x > y; }
+
+std::size_t last_digit(int x) { return x % 10; }
+
+bool last_digit_less(int x, int y) { return last_digit(x) < last_digit(y); }
+
+void test_three_way_partition() {
+  std::vector<int> dups;
+  for (int i = 0; i < 1000; i++)
+    dups.push_back(i * 7 % 5);
+  std::pair<vec_iter, vec_iter> res =
+      algs::three_way_partition(dups.begin(), dups.end(), 2);
+  assert(res.first - dups.begin() == 400 && res.second - dups.begin() == 600);
+  for (vec_iter it = dups.begin(); it != dups.end(); ++it)
+    assert(*it == 2 ? it >= res.first && it < res.second
+                    : (*it < 2) == (it < res.first));
+  // the pivot may refer to an element of the range
+  res = algs::three_way_partition(dups.begin(), dups.end(), dups.back(),
+                                  greater);
+  assert(res.first - dups.begin() == 0 && res.second - dups.begin() == 200);
+  res = algs::three_way_partition(v6.begin(), v6.end(), 0);
+  assert(res.first == v6.begin() && res.second == v6.end());
+}
+
+void test_bucket_partition() {
+  std::vector<int> big;
+  for (int i = 0; i < 5000; i++)
+    big.push_back(int(i * 7919L % 1009));
+  std::vector<std::size_t> bounds(11);
+  std::vector<int> res_algs = big;
+  algs::bucket_partition(res_algs.begin(), res_algs.end(), 10, last_digit,
+                         bounds.begin());
+  assert(bounds[0] == 0 && bounds[10] == big.size());
+  for (std::size_t j = 0; j < 10; j++)
+    for (std::size_t i = bounds[j]; i < bounds[j + 1]; i++)
+      assert(last_digit(res_algs[i]) == j);
+  std::vector<int> sorted = big;
+  std::sort(sorted.begin(), sorted.end());
+  std::sort(res_algs.begin(), res_algs.end());
+  assert(res_algs == sorted);
+  // the copying version is stable
+  std::vector<int> res_std = big;
+  std::stable_sort(res_std.begin(), res_std.end(), last_digit_less);
+  std::vector<std::size_t> copy_bounds(11);
+  res_algs.assign(big.size(), -1);
+  vec_iter end = algs::bucket_partition_copy(
+      big.begin(), big.end(), res_algs.begin(), 10, last_digit,
+      copy_bounds.begin());
+  assert(end == res_algs.end() && copy_bounds == bounds);
+  assert(res_algs == res_std);
+}
+
+// sorts a copy of v with both libraries, ascending and descending
+void check_sort(const std::vector<int> &v) {
+  std::vector<int> res_algs = v, res_std = v;
+  algs::sort(res_algs.begin(), res_algs.end());
+  std::sort(res_std.begin(), res_std.end());
+  assert(res_algs == res_std);
+  res_algs = v;
+  algs::sort(res_algs.begin(), res_algs.end(), greater);
+  std::reverse(res_std.begin(), res_std.end());
+  assert(res_algs == res_std);
+}
+
+void test_sort() {
+  std::vector<int> big;
+  for (int i = 0; i < 20000; i++)
+    big.push_back(int(i * 7919L % 10007));
+  check_sort(big);
+  check_sort(v1);
+  check_sort(v3);
+  check_sort(v6);
+  // few distinct keys, organ pipe, and ascending runs with outliers
+  std::vector<int> pattern;
+  for (int i = 0; i < 20000; i++)
+    pattern.push_back(i % 3);
+  check_sort(pattern);
+  for (int i = 0; i < 20000; i++)
+    pattern[i] = i < 10000 ? i : 20000 - i;
+  check_sort(pattern);
+  for (int i = 0; i < 20000; i++)
+    pattern[i] = i % 1000 ? i : big[i];
+  check_sort(pattern);
+  std::deque<std::string> words;
+  words.push_back("pear");
+  words.push_back("apple");
+  words.push_back("fig");
+  algs::sort(words.begin(), words.end());
+  assert(words[0] == "apple" && words[1] == "fig" && words[2] == "pear");
+}
+
+// less than on ints, counting its calls from any thread into *count
+struct counting_less {
+  long *count;
+
+  bool operator()(int x, int y) const {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    ++*count;
+    return x < y;
+  }
+};
+
+// parallel sorts a copy of v and returns the comparisons it took
+long parallel_sort_comparisons(const std::vector<int> &v) {
+  std::vector<int> res_algs = v, res_std = v;
+  long count = 0;
+  counting_less less = {&count};
+  algs::sort(algs::par, res_algs.begin(), res_algs.end(), less);
+  std::sort(res_std.begin(), res_std.end());
+  assert(res_algs == res_std);
+  return count;
+}
+
+void test_parallel_sort() {
+  std::vector<int> big;
+  for (int i = 0; i < 300000; i++)
+    big.push_back(int(i * 7919L % 100003));
+  std::vector<int> res_std = big;
+  std::sort(res_std.begin(), res_std.end());
+  algs::sort(algs::par, big.begin(), big.end());
+  assert(big == res_std);
+  // already sorted, descending by comparator, and few distinct keys
+  algs::sort(algs::par, big.begin(), big.end());
+  assert(big == res_std);
+  algs::sort(algs::par, big.begin(), big.end(), greater);
+  std::sort(res_std.begin(), res_std.end(), greater);
+  assert(big == res_std);
+  for (int i = 0; i < 300000; i++)
+    big[i] = int(i * 7919L % 5);
+  res_std = big;
+  std::sort(res_std.begin(), res_std.end());
+  algs::sort(algs::par, big.begin(), big.end());
+  assert(big == res_std);
+  // a key filling the sample gets an equality bucket that is never sorted
+  std::vector<int> same(300000, 7), three;
+  for (int i = 0; i < 300000; i++)
+    three.push_back(int(i * 7919L % 3));
+  assert(parallel_sort_comparisons(same) < 2L * 300000);
+  assert(parallel_sort_comparisons(three) < 7L * 300000);
+  std::deque<std::string> words;
+  for (int i = 0; i < 100000; i++)
+    words.push_back(std::string(1 + i % 3, char('a' + i * 31 % 26)));
+  std::deque<std::string> sorted_words = words;
+  std::sort(sorted_words.begin(), sorted_words.end());
+  algs::sort(algs::par, words.begin(), words.end());
+  assert(words == sorted_words);
+  algs::sort(algs::par, v3.begin(), v3.end());
+  assert(v3[0] == 1 && v3[9] == 10);
+}
+
+// stable sorts a copy of v with both libraries, by value and by last digit
+void check_stable_sort(const std::vector<int> &v) {
+  std::vector<int> res_algs = v, res_std = v;
+  algs::stable_sort(res_algs.begin(), res_algs.end());
+  std::stable_sort(res_std.begin(), res_std.end());
+  assert(res_algs == res_std);
+  res_algs = res_std = v;
+  algs::stable_sort(res_algs.begin(), res_algs.end(), last_digit_less);
+  std::stable_sort(res_std.begin(), res_std.end(), last_digit_less);
+  assert(res_algs == res_std);
+  // scratch buffers too short for some merges, or for all of them
+  std::ptrdiff_t lens[] = {0, 1, 7, std::ptrdiff_t(v.size() / 5)};
+  for (int i = 0; i < 4; i++) {
+    std::vector<int> buf(lens[i] + 1);
+    res_algs = v;
+    algs::stable_sort(res_algs.begin(), res_algs.end(), last_digit_less,
+                      &buf[0], lens[i]);
+    assert(res_algs == res_std);
+  }
+}
+
+void test_stable_sort() {
+  std::vector<int> big;
+  for (int i = 0; i < 20000; i++)
+    big.push_back(int(i * 7919L % 10007));
+  check_stable_sort(big);
+  check_stable_sort(v1);
+  check_stable_sort(v3);
+  check_stable_sort(v6);
+  for (int n = 0; n < 200; n += 13)
+    check_stable_sort(std::vector<int>(big.begin(), big.begin() + n));
+  // sorted with an unsorted tail, descending, organ pipe, sawtooth, few keys
+  std::vector<int> pattern(20000);
+  for (int i = 0; i < 20000; i++)
+    pattern[i] = i < 19000 ? i : big[i];
+  check_stable_sort(pattern);
+  for (int i = 0; i < 20000; i++)
+    pattern[i] = 20000 - i;
+  check_stable_sort(pattern);
+  for (int i = 0; i < 20000; i++)
+    pattern[i] = i < 10000 ? i : 20000 - i;
+  check_stable_sort(pattern);
+  for (int i = 0; i < 20000; i++)
+    pattern[i] = i % 997 * 10 + i % 7;
+  check_stable_sort(pattern);
+  for (int i = 0; i < 20000; i++)
+    pattern[i] = i % 3;
+  check_stable_sort(pattern);
+  // runs of equal keys descending: reversing them would break stability
+  for (int i = 0; i < 20000; i++)
+    pattern[i] = (20000 - i) / 50 * 10 + i % 10;
+  check_stable_sort(pattern);
+  std::deque<std::string> words;
+  words.push_back("pear");
+  words.push_back("apple");
+  words.push_back("fig");
+  algs::stable_sort(words.begin(), words.end());
+  assert(words[0] == "apple" && words[1] == "fig" && words[2] == "pear");
+}
+
+// radix sorts a copy of v and compares with std::sort
+template <class T> static void check_radix_sort(const std::vector<T> &v) {
+  std::vector<T> res_algs = v, res_std = v;
+  algs::radix_sort(res_algs.begin(), res_algs.end());
+  std::sort(res_std.begin(), res_std.end());
+  assert(res_algs == res_std);
+}
+
+// values of type T spread over the whole type, or only over its low bits
+template <class T> static std::vector<T> radix_values(long n, int bits) {
+  std::vector<T> v;
+  unsigned long long x = 88172645463325252ull;
+  for (long i = 0; i < n; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    v.push_back(T(bits < 64 ? x & ((1ull << bits) - 1) : x));
+  }
+  return v;
+}
+
+struct record {
+  double weight;
+  int id;
+};
+
+struct record_weight {
+  typedef double result_type;
+
+  double operator()(const record &r) const { return r.weight; }
+};
+
+int record_bucket(const record &r) { return r.id % 7 - 3; }
+
+bool record_weight_less(const record &x, const record &y) {
+  return x.weight < y.weight;
+}
+
+bool record_bucket_less(const record &x, const record &y) {
+  return record_bucket(x) < record_bucket(y);
+}
+
+static bool same_records(const std::vector<record> &x,
+                         const std::vector<record> &y) {
+  for (std::size_t i = 0; i < x.size(); i++)
+    if (x[i].id != y[i].id)
+      return false;
+  return x.size() == y.size();
+}
+
+void test_radix_sort() {
+  long sizes[] = {0, 1, 100, 255, 256, 5000, 70000};
+  for (int i = 0; i < 7; i++) {
+    long n = sizes[i];
+    check_radix_sort(radix_values<int>(n, 64));
+    check_radix_sort(radix_values<int>(n, 12));
+    check_radix_sort(radix_values<unsigned>(n, 64));
+    check_radix_sort(radix_values<unsigned>(n, 20));
+    check_radix_sort(radix_values<short>(n, 64));
+    check_radix_sort(radix_values<signed char>(n, 64));
+    check_radix_sort(radix_values<char>(n, 64));
+    check_radix_sort(radix_values<long>(n, 64));
+    check_radix_sort(radix_values<long>(n, 40));
+    check_radix_sort(radix_values<unsigned long>(n, 64));
+    std::vector<double> d;
+    std::vector<float> f;
+    std::vector<int> ints = radix_values<int>(n, 64);
+    for (long j = 0; j < n; j++) {
+      d.push_back(ints[j] / 1024.0);
+      f.push_back(float(ints[j] % 100000) / 8);
+    }
+    if (n > 10) {
+      d[3] = -std::numeric_limits<double>::infinity();
+      d[5] = std::numeric_limits<double>::infinity();
+      d[7] = -0.0;
+      f[4] = std::numeric_limits<float>::min();
+      f[6] = -std::numeric_limits<float>::max();
+    }
+    check_radix_sort(d);
+    check_radix_sort(f);
+  }
+  // -0.0 just before 0.0
+  std::vector<double> zeros(300, 0.0);
+  zeros[299] = -0.0;
+  algs::radix_sort(zeros.begin(), zeros.end());
+  assert(1 / zeros[0] < 0 && 1 / zeros[1] > 0);
+  // stable by an extracted key, with a functor and a function pointer
+  std::vector<record> records;
+  std::vector<int> ints = radix_values<int>(20000, 64);
+  for (int i = 0; i < 20000; i++) {
+    record r = {(ints[i] % 500) * 0.25, i};
+    records.push_back(r);
+  }
+  std::vector<record> res_algs = records, res_std = records;
+  algs::radix_sort(res_algs.begin(), res_algs.end(), record_weight());
+  std::stable_sort(res_std.begin(), res_std.end(), record_weight_less);
+  assert(same_records(res_algs, res_std));
+  res_algs = res_std = records;
+  algs::radix_sort(res_algs.begin(), res_algs.end(), record_bucket);
+  std::stable_sort(res_std.begin(), res_std.end(), record_bucket_less);
+  assert(same_records(res_algs, res_std));
+  std::deque<int> dq(ints.begin(), ints.end());
+  algs::radix_sort(dq.begin(), dq.end());
+  std::sort(ints.begin(), ints.end());
+  assert(std::equal(dq.begin(), dq.end(), ints.begin()));
+}
+
+void test_parallel_radix_sort() {
+  std::vector<long> v = radix_values<long>(300000, 64), res_std = v;
+  std::sort(res_std.begin(), res_std.end());
+  algs::radix_sort(algs::par, v.begin(), v.end());
+  assert(v == res_std);
+  std::vector<int> narrow = radix_values<int>(200000, 18),
+                   sorted_narrow = narrow;
+  std::sort(sorted_narrow.begin(), sorted_narrow.end());
+  algs::radix_sort(algs::par, narrow.begin(), narrow.end());
+  assert(narrow == sorted_narrow);
+  // most keys in one bucket of the first split, which is split again
+  std::vector<int> skewed = radix_values<int>(200000, 64);
+  for (int i = 0; i < 200000; i++)
+    if (i % 10)
+      skewed[i] &= 0xffff;
+  sorted_narrow = skewed;
+  std::sort(sorted_narrow.begin(), sorted_narrow.end());
+  algs::radix_sort(algs::par, skewed.begin(), skewed.end());
+  assert(skewed == sorted_narrow);
+  std::vector<record> records;
+  for (int i = 0; i < 100000; i++) {
+    record r = {(v[i] % 1000) * 0.5, i};
+    records.push_back(r);
+  }
+  std::vector<record> res_algs = records, res_rec = records;
+  algs::radix_sort(algs::par, res_algs.begin(), res_algs.end(),
+                   record_weight());
+  std::stable_sort(res_rec.begin(), res_rec.end(), record_weight_less);
+  assert(same_records(res_algs, res_rec));
+  res_algs = records;
+  algs::radix_sort(algs::par, res_algs.begin(), res_algs.begin() + 50,
+                   record_bucket);
+  std::stable_sort(records.begin(), records.begin() + 50, record_bucket_less);
+  assert(same_records(res_algs, records));
+}
+
+// sorts copies of the first n elements of v with sort_small and std::sort
+template <class T> void check_sort_small(const std::vector<T> &v) {
+  for (std::size_t n = 0; n <= v.size(); n++) {
+    std::vector<T> res_algs(v.begin(), v.begin() + n), res_std = res_algs;
+    algs::sort_small(res_algs.begin(), res_algs.end());
+    std::sort(res_std.begin(), res_std.end());
+    assert(res_algs == res_std);
+  }
+}
+
+void test_sort_small() {
+  // every length up to past the longest network, with the largest value of
+  // the type among the elements as well as padding them
+  std::vector<int> ints = radix_values<int>(300, 32);
+  ints[7] = ints[100] = std::numeric_limits<int>::max();
+  ints[50] = std::numeric_limits<int>::min();
+  check_sort_small(ints);
+  std::vector<long> longs = radix_values<long>(300, 64);
+  longs[3] = std::numeric_limits<long>::max();
+  check_sort_small(longs);
+  std::vector<long long> wide(longs.begin(), longs.end());
+  check_sort_small(wide);
+  std::vector<double> doubles;
+  std::vector<float> floats;
+  for (int i = 0; i < 300; i++) {
+    doubles.push_back(ints[i] / 7.0);
+    floats.push_back(float(ints[i] % 1000) / 8);
+  }
+  doubles[9] = std::numeric_limits<double>::infinity();
+  check_sort_small(doubles);
+  check_sort_small(floats);
+  // equal zeros of either sign are all kept
+  std::vector<float> zeros;
+  for (int i = 0; i < 100; i++)
+    zeros.push_back(i % 3 ? 0.0f : -0.0f);
+  algs::sort_small(zeros.begin(), zeros.end());
+  int negative = 0;
+  for (int i = 0; i < 100; i++) {
+    unsigned bits;
+    std::memcpy(&bits, &zeros[i], sizeof bits);
+    negative += bits >> 31;
+  }
+  assert(negative == 34);
+  // comparators, other containers and longer ranges go through sort
+  std::vector<int> res_algs = ints, res_std = ints;
+  algs::sort_small(res_algs.begin(), res_algs.end(), greater);
+  std::sort(res_std.begin(), res_std.end(), greater);
+  assert(res_algs == res_std);
+  std::deque<int> dq(ints.begin(), ints.begin() + 40);
+  algs::sort_small(dq.begin(), dq.end());
+  std::sort(ints.begin(), ints.begin() + 40);
+  assert(std::equal(dq.begin(), dq.end(), ints.begin()));
+  algs::sort_small(v3.begin(), v3.end());
+  assert(v3[0] == 1 && v3[9] == 10);
+}
+
+// McIlroy's adversary: values are fixed lazily as the comparisons demand,
+// the element compared most recently while still unfixed being made the
+// smallest of the rest, which defeats the pivot choices of a quickselect
+struct adversary_less {
+  std::vector<int> *val;
+  int *fixed, *candidate;
+  long *count;
+
+  bool operator()(int x, int y) const {
+    std::vector<int> &v = *val;
+    int gas = int(v.size());
+    ++*count;
+    if (v[x] == gas && v[y] == gas)
+      v[x == *candidate ? x : y] = (*fixed)++;
+    if (v[x] == gas)
+      *candidate = x;
+    else if (v[y] == gas)
+      *candidate = y;
+    return v[x] < v[y];
+  }
+};
+
+void test_nth_element() {
+  std::vector<int> big;
+  for (int i = 0; i < 20000; i++)
+    big.push_back(int(i * 7919L % 10007));
+  std::vector<int> sorted = big;
+  std::sort(sorted.begin(), sorted.end());
+  const int ranks[] = {0, 1, 9999, 10000, 19998, 19999};
+  for (int r = 0; r < 6; r++) {
+    std::vector<int> res_algs = big;
+    vec_iter nth = res_algs.begin() + ranks[r];
+    algs::nth_element(res_algs.begin(), nth, res_algs.end());
+    assert(*nth == sorted[ranks[r]]);
+    for (vec_iter it = res_algs.begin(); it != res_algs.end(); ++it)
+      assert(it < nth ? !(*nth < *it) : !(*it < *nth));
+  }
+  algs::nth_element(v1.begin(), v1.begin() + 3, v1.end(), greater);
+  assert(v1[3] == 6);
+  algs::nth_element(v6.begin(), v6.begin() + 10, v6.end());
+  assert(v6[10] == 0);
+  // linear number of comparisons against an adversary
+  const int n = 1 << 16;
+  std::vector<int> val(n, n), items;
+  for (int i = 0; i < n; i++)
+    items.push_back(i);
+  int fixed = 0, candidate = 0;
+  long count = 0;
+  adversary_less adversary = {&val, &fixed, &candidate, &count};
+  algs::nth_element(items.begin(), items.begin() + n / 2, items.end(),
+                    adversary);
+  assert(count < 16L * n);
+  for (int i = 0; i < n; i++)
+    assert(i < n / 2 ? val[items[i]] <= val[items[n / 2]]
+                     : val[items[i]] >= val[items[n / 2]]);
+}
+
+void test_partial_sort() {
+  std::vector<int> big;
+  for (int i = 0; i < 20000; i++)
+    big.push_back(int(i * 7919L % 10007));
+  std::vector<int> sorted = big;
+  std::sort(sorted.begin(), sorted.end());
+  // a small prefix uses the bounded heap, a large one selects and sorts
+  const int lengths[] = {0, 1, 100, 5000, 20000};
+  for (int l = 0; l < 5; l++) {
+    std::vector<int> res_algs = big;
+    algs::partial_sort(res_algs.begin(), res_algs.begin() + lengths[l],
+                       res_algs.end());
+    assert(std::equal(res_algs.begin(), res_algs.begin() + lengths[l],
+                      sorted.begin()));
+    std::sort(res_algs.begin(), res_algs.end());
+    assert(res_algs == sorted);
+  }
+  algs::partial_sort(v1.begin(), v1.begin() + 2, v1.end(), greater);
+  assert(v1[0] == 9 && v1[1] == 8);
+}
+
+void test_partial_sort_copy() {
+  std::list<int> stream;
+  for (int i = 0; i < 20000; i++)
+    stream.push_back(int(i * 7919L % 10007));
+  std::vector<int> sorted(stream.begin(), stream.end());
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<int> top(100);
+  vec_iter end = algs::partial_sort_copy(stream.begin(), stream.end(),
+                                         top.begin(), top.end());
+  assert(end == top.end());
+  assert(std::equal(top.begin(), top.end(), sorted.begin()));
+  // a destination longer than the input receives all of it
+  std::vector<int> all(30);
+  end = algs::partial_sort_copy(v3.begin(), v3.end(), all.begin(), all.end(),
+                                greater);
+  assert(end - all.begin() == 10 && all[0] == 10 && all[9] == 1);
+  assert(algs::partial_sort_copy(v1.begin(), v1.end(), all.begin(),
+                                 all.begin()) == all.begin());
+}
+
 // TODO: Implement
 void test_accumulate() {}
 
@@ -132,6 +917,563 @@ void test_binary_search() {
   assert(res2_algs == false);
 }
 
+void test_partition_point() {
+  std::vector<int> parts = v5;
+  parts.insert(parts.end(), v4.begin(), v4.end());
+  vec_iter res_algs = algs::partition_point(parts.begin(), parts.end(), is_even);
+  assert(res_algs - parts.begin() == 11);
+  std::list<int> l(parts.begin(), parts.end());
+  assert(*algs::partition_point(l.begin(), l.end(), is_even) == 1);
+  assert(algs::partition_point(v6.begin(), v6.end(), is_even) == v6.end());
+  for (int n = 0; n < 40; n++) {
+    std::vector<int> odd_tail(n, 2);
+    for (int k = n; k >= 0; k--) {
+      assert(algs::partition_point(odd_tail.begin(), odd_tail.end(),
+                                   is_even) == odd_tail.begin() + k);
+      if (k > 0)
+        odd_tail[k - 1] = 1;
+    }
+  }
+}
+
+void test_lower_bound() {
+  std::vector<int> dups;
+  for (int i = 0; i < 100; i++)
+    dups.push_back(i / 3);
+  for (int x = -1; x <= 34; x++) {
+    vec_iter res_algs = algs::lower_bound(dups.begin(), dups.end(), x);
+    assert(res_algs == std::lower_bound(dups.begin(), dups.end(), x));
+  }
+  assert(algs::lower_bound(v3.begin(), v3.end(), 4, greater) ==
+         v3.begin() + 6);
+  std::list<int> l(v5.begin(), v5.end());
+  assert(*algs::lower_bound(l.begin(), l.end(), 7) == 8);
+}
+
+void test_upper_bound() {
+  std::vector<int> dups;
+  for (int i = 0; i < 100; i++)
+    dups.push_back(i / 3);
+  for (int x = -1; x <= 34; x++) {
+    vec_iter res_algs = algs::upper_bound(dups.begin(), dups.end(), x);
+    assert(res_algs == std::upper_bound(dups.begin(), dups.end(), x));
+  }
+  assert(algs::upper_bound(v3.begin(), v3.end(), 4, greater) ==
+         v3.begin() + 7);
+  assert(algs::upper_bound(v6.begin(), v6.end(), 0) == v6.end());
+}
+
+void test_equal_range() {
+  std::pair<vec_iter, vec_iter> res_algs =
+      algs::equal_range(v6.begin(), v6.end(), 0);
+  assert(res_algs.first == v6.begin() && res_algs.second == v6.end());
+  res_algs = algs::equal_range(v1.begin(), v1.end(), 4);
+  assert(res_algs.first == v1.begin() + 4 && res_algs.second == v1.begin() + 5);
+  res_algs = algs::equal_range(v5.begin(), v5.end(), 5);
+  assert(res_algs.first == res_algs.second && *res_algs.first == 6);
+  res_algs = algs::equal_range(v3.begin(), v3.end(), 7, greater);
+  assert(res_algs.first == v3.begin() + 3 && res_algs.second - res_algs.first == 1);
+  assert(algs::binary_search(v3.begin(), v3.end(), 7, greater));
+  assert(!algs::binary_search(v3.begin(), v3.end(), 0, greater));
+}
+
+void test_lower_bound_batch() {
+  std::vector<int> table;
+  for (int i = 0; i < 100000; i++)
+    table.push_back(i / 2 * 2);
+  std::list<int> queries;
+  for (int i = 0; i < 1000; i++)
+    queries.push_back(int(i * 7919L % 100003) - 1);
+  std::vector<vec_iter> res_algs;
+  algs::lower_bound_batch(table.begin(), table.end(), queries.begin(),
+                          queries.end(), std::back_inserter(res_algs));
+  assert(res_algs.size() == queries.size());
+  std::list<int>::iterator q = queries.begin();
+  for (std::size_t i = 0; i < res_algs.size(); i++, ++q)
+    assert(res_algs[i] == std::lower_bound(table.begin(), table.end(), *q));
+  int small[] = {9, 4, 0, 10};
+  vec_iter res_small[4];
+  algs::lower_bound_batch(v3.begin(), v3.end(), small, small + 4, res_small,
+                          greater);
+  for (int i = 0; i < 4; i++)
+    assert(res_small[i] ==
+           std::lower_bound(v3.begin(), v3.end(), small[i], greater));
+  assert(algs::lower_bound_batch(v6.begin(), v6.end(), small, small,
+                                 res_small) == res_small);
+}
+
+void test_binary_search_batch() {
+  std::vector<int> table;
+  for (int i = 0; i < 100000; i++)
+    table.push_back(i * 3);
+  std::vector<int> queries;
+  for (int i = 0; i < 1000; i++)
+    queries.push_back(int(i * 7919L % 300005) - 2);
+  std::vector<bool> res_algs(queries.size());
+  std::vector<bool>::iterator end =
+      algs::binary_search_batch(table.begin(), table.end(), queries.begin(),
+                                queries.end(), res_algs.begin());
+  assert(end == res_algs.end());
+  for (std::size_t i = 0; i < queries.size(); i++)
+    assert(res_algs[i] == (queries[i] >= 0 && queries[i] < 300000 &&
+                           queries[i] % 3 == 0));
+  bool res_small[3];
+  int small[] = {7, 0, 9};
+  algs::binary_search_batch(v3.begin(), v3.end(), small, small + 3, res_small,
+                            greater);
+  assert(res_small[0] && !res_small[1] && res_small[2]);
+}
+
+void test_interpolation_search() {
+  std::vector<long> squares;
+  for (long i = 0; i < 2000; i++)
+    squares.push_back(i / 3 * (i / 3));
+  for (long x = -1; x < 450000; x += 97) {
+    assert(algs::interpolation_lower_bound(squares.begin(), squares.end(), x) ==
+           std::lower_bound(squares.begin(), squares.end(), x));
+    assert(algs::interpolation_search(squares.begin(), squares.end(), x) ==
+           std::binary_search(squares.begin(), squares.end(), x));
+  }
+  assert(algs::interpolation_search(v1.begin(), v1.end(), 4));
+  assert(algs::interpolation_search(v6.begin(), v6.end(), 0));
+  assert(!algs::interpolation_search(v6.begin(), v6.end(), 1));
+  double inf = std::numeric_limits<double>::infinity();
+  double d[] = {-inf, -1e300, -2.5, 0.0, 0.0, 1.0, 1e300, inf};
+  for (int i = 0; i < 8; i++)
+    assert(algs::interpolation_lower_bound(d, d + 8, d[i]) ==
+           std::lower_bound(d, d + 8, d[i]));
+  assert(algs::interpolation_lower_bound(d, d + 8, 0.5) == d + 5);
+}
+
+void test_exponential_search() {
+  std::vector<int> dups;
+  for (int i = 0; i < 100; i++)
+    dups.push_back(i / 3);
+  for (int h = 0; h <= 100; h++)
+    for (int x = -1; x <= 34; x++) {
+      vec_iter hint = dups.begin() + h;
+      assert(algs::exponential_lower_bound(dups.begin(), dups.end(), hint, x) ==
+             std::lower_bound(dups.begin(), dups.end(), x));
+      assert(algs::exponential_search(dups.begin(), dups.end(), hint, x) ==
+             (x >= 0 && x < 34));
+    }
+  assert(algs::exponential_lower_bound(v3.begin(), v3.end(), v3.begin(), 4,
+                                       greater) == v3.begin() + 6);
+  assert(!algs::exponential_search(v6.begin(), v6.end(), v6.end(), 1));
+}
+
+template <class T>
+static void check_learned_index(const std::vector<T> &v, std::ptrdiff_t err,
+                                const std::vector<T> &queries) {
+  algs::learned_index<T> index(v.begin(), v.end(), err);
+  for (std::size_t i = 0; i < queries.size(); i++) {
+    T x = queries[i];
+    assert(index.lower_bound(v.begin(), v.end(), x) ==
+           std::lower_bound(v.begin(), v.end(), x));
+    assert(index.contains(v.begin(), v.end(), x) ==
+           std::binary_search(v.begin(), v.end(), x));
+  }
+}
+
+void test_learned_index() {
+  std::vector<long> keys, queries;
+  for (long i = 0; i < 5000; i++)
+    keys.push_back(i < 2500 ? i * 3 : i * i / 7 + (i % 10 == 0 ? 0 : -1000));
+  std::sort(keys.begin(), keys.end());
+  for (long i = 0; i < 3000; i++)
+    queries.push_back(i * 7919 % 3600000 - 50);
+  for (long err = 0; err <= 64; err += 16)
+    check_learned_index(keys, err, queries);
+  algs::learned_index<long> index(keys.begin(), keys.end());
+  assert(index.segments() > 1 && index.segments() < 100);
+  std::vector<long> dups(1000, 5);
+  dups.insert(dups.end(), 1000, 9);
+  check_learned_index(dups, 4, queries);
+  std::vector<unsigned long> wide, wide_queries;
+  for (unsigned long i = 0; i < 1000; i++) {
+    wide.push_back(i * i * 18446744073709ul);
+    wide_queries.push_back(i * i * 18446744073709ul + i % 3 - 1);
+  }
+  check_learned_index(wide, 8, wide_queries);
+  std::vector<long> none;
+  check_learned_index(none, 8, queries);
+}
+
+/*
+ * Sorted multiset of n values below m, with runs of repeats when m < n
+ */
+template <class T> static std::vector<T> sorted_values(long n, long m, long seed) {
+  std::vector<T> v;
+  for (long i = 0; i < n; i++)
+    v.push_back(T((i * 7919 + seed) * 104729 % m));
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+static const long set_sizes[][2] = {{0, 10},   {10, 0},    {300, 290},
+                                    {2000, 3000}, {500, 40000}, {40000, 700},
+                                    {50, 49},  {1000, 1000}};
+
+void test_set_intersection() {
+  for (int t = 0; t < 8; t++) {
+    long n1 = set_sizes[t][0], n2 = set_sizes[t][1];
+    for (long m = 64; m <= 1L << 20; m *= 16) {
+      std::vector<int> a = sorted_values<int>(n1, m, 1),
+                       b = sorted_values<int>(n2, m, 2), res_std, res_algs;
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                            std::back_inserter(res_std));
+      algs::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                             std::back_inserter(res_algs));
+      assert(res_algs == res_std);
+      assert(algs::set_intersection_size(a.begin(), a.end(), b.begin(),
+                                         b.end()) == (long)res_std.size());
+      std::vector<unsigned> ua(a.begin(), a.end()), ub(b.begin(), b.end()),
+          ures(ua.size());
+      ures.erase(algs::set_intersection(ua.begin(), ua.end(), ub.begin(),
+                                        ub.end(), ures.begin()),
+                 ures.end());
+      assert(std::equal(ures.begin(), ures.end(), res_std.begin()) &&
+             ures.size() == res_std.size());
+      std::vector<long> la(a.begin(), a.end()), lres;
+      algs::set_intersection(la.begin(), la.end(), b.begin(), b.end(),
+                             std::back_inserter(lres));
+      assert(std::equal(lres.begin(), lres.end(), res_std.begin()) &&
+             lres.size() == res_std.size());
+      std::list<int> l(b.begin(), b.end());
+      res_algs.clear();
+      algs::set_intersection(a.begin(), a.end(), l.begin(), l.end(),
+                             std::back_inserter(res_algs));
+      assert(res_algs == res_std);
+    }
+  }
+  std::vector<int> rev_a = sorted_values<int>(3000, 5000, 3),
+                   rev_b = sorted_values<int>(100, 5000, 4), res_std, res_algs;
+  std::reverse(rev_a.begin(), rev_a.end());
+  std::reverse(rev_b.begin(), rev_b.end());
+  std::set_intersection(rev_a.begin(), rev_a.end(), rev_b.begin(), rev_b.end(),
+                        std::back_inserter(res_std), greater);
+  algs::set_intersection(rev_a.begin(), rev_a.end(), rev_b.begin(),
+                         rev_b.end(), std::back_inserter(res_algs), greater);
+  assert(res_algs == res_std);
+}
+
+void test_set_union() {
+  for (int t = 0; t < 8; t++) {
+    long n1 = set_sizes[t][0], n2 = set_sizes[t][1];
+    for (long m = 64; m <= 1L << 20; m *= 16) {
+      std::vector<int> a = sorted_values<int>(n1, m, 5),
+                       b = sorted_values<int>(n2, m, 6), res_std, res_algs;
+      std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                     std::back_inserter(res_std));
+      algs::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                      std::back_inserter(res_algs));
+      assert(res_algs == res_std);
+      std::list<int> l(a.begin(), a.end());
+      res_algs.clear();
+      algs::set_union(l.begin(), l.end(), b.begin(), b.end(),
+                      std::back_inserter(res_algs));
+      assert(res_algs == res_std);
+    }
+  }
+  // Equivalent elements are taken from the first sequence
+  std::vector<int> a(v1.begin(), v1.end()), b, res_algs;
+  for (std::size_t i = 0; i < a.size(); i++)
+    b.push_back(a[i] + 10);
+  algs::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                  std::back_inserter(res_algs), last_digit_less);
+  assert(std::equal(a.begin(), a.end(), res_algs.begin()));
+}
+
+void test_set_difference() {
+  for (int t = 0; t < 8; t++) {
+    long n1 = set_sizes[t][0], n2 = set_sizes[t][1];
+    for (long m = 64; m <= 1L << 20; m *= 16) {
+      std::vector<int> a = sorted_values<int>(n1, m, 7),
+                       b = sorted_values<int>(n2, m, 8), res_std, res_algs;
+      std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(res_std));
+      algs::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                           std::back_inserter(res_algs));
+      assert(res_algs == res_std);
+      std::list<int> l(b.begin(), b.end());
+      res_algs.clear();
+      algs::set_difference(a.begin(), a.end(), l.begin(), l.end(),
+                           std::back_inserter(res_algs));
+      assert(res_algs == res_std);
+    }
+  }
+}
+
+void test_includes() {
+  for (int t = 0; t < 8; t++) {
+    long n1 = set_sizes[t][0], n2 = set_sizes[t][1];
+    std::vector<int> a = sorted_values<int>(n1, 4096, 9),
+                     b = sorted_values<int>(n2, 4096, 10), sub;
+    for (std::size_t i = 0; i < a.size(); i += 3)
+      sub.push_back(a[i]);
+    assert(algs::includes(a.begin(), a.end(), sub.begin(), sub.end()));
+    assert(algs::includes(a.begin(), a.end(), b.begin(), b.end()) ==
+           std::includes(a.begin(), a.end(), b.begin(), b.end()));
+    if (!sub.empty()) {
+      sub.push_back(sub.back());
+      sub.push_back(sub.back());
+      sub.push_back(sub.back());
+      std::sort(sub.begin(), sub.end());
+      assert(algs::includes(a.begin(), a.end(), sub.begin(), sub.end()) ==
+             std::includes(a.begin(), a.end(), sub.begin(), sub.end()));
+    }
+    std::list<int> l(a.begin(), a.end());
+    assert(algs::includes(l.begin(), l.end(), sub.begin(), sub.end()) ==
+           std::includes(a.begin(), a.end(), sub.begin(), sub.end()));
+  }
+  assert(algs::includes(v3.begin(), v3.end(), v3.begin() + 2, v3.end(),
+                        greater));
+}
+
+bool half_less(int x, int y) { return x / 2 < y / 2; }
+
+/*
+ * Splits sorted v into two sorted halves holding 2x and 2x+1 for alternate
+ * elements x, equivalent under half_less: a stable merge of the even half
+ * with the odd one under half_less must come out fully sorted
+ */
+static void halves(const std::vector<int> &v, std::vector<int> &even,
+                   std::vector<int> &odd) {
+  for (std::size_t i = 0; i < v.size(); i++) {
+    if (i % 2)
+      odd.push_back(2 * v[i] + 1);
+    else
+      even.push_back(2 * v[i]);
+  }
+}
+
+void test_merge() {
+  for (int t = 0; t < 8; t++) {
+    long n1 = set_sizes[t][0], n2 = set_sizes[t][1];
+    for (long m = 64; m <= 1L << 20; m *= 16) {
+      std::vector<int> a = sorted_values<int>(n1, m, 3),
+                       b = sorted_values<int>(n2, m, 4), res_std, res_algs;
+      std::merge(a.begin(), a.end(), b.begin(), b.end(),
+                 std::back_inserter(res_std));
+      algs::merge(a.begin(), a.end(), b.begin(), b.end(),
+                  std::back_inserter(res_algs));
+      assert(res_algs == res_std);
+      std::list<int> l(b.begin(), b.end());
+      res_algs.assign(n1 + n2, -1);
+      assert(algs::merge(a.begin(), a.end(), l.begin(), l.end(),
+                         res_algs.begin()) == res_algs.end());
+      assert(res_algs == res_std);
+    }
+  }
+  std::vector<int> even, odd, res_std, res_algs(4000);
+  halves(sorted_values<int>(4000, 300, 5), even, odd);
+  res_std = even;
+  res_std.insert(res_std.end(), odd.begin(), odd.end());
+  std::sort(res_std.begin(), res_std.end());
+  algs::merge(even.begin(), even.end(), odd.begin(), odd.end(),
+              res_algs.begin(), half_less);
+  assert(res_algs == res_std);
+  res_algs.assign(20, 0);
+  res_std.assign(20, 0);
+  algs::merge(v3.begin(), v3.end(), v3.begin(), v3.end(), res_algs.begin(),
+              greater);
+  std::merge(v3.begin(), v3.end(), v3.begin(), v3.end(), res_std.begin(),
+             greater);
+  assert(res_algs == res_std);
+}
+
+void test_parallel_merge() {
+  long sizes[][2] = {{200000, 200000}, {300000, 5}, {7, 300000},
+                     {150000, 0},      {0, 90000},  {100, 100}};
+  for (int t = 0; t < 6; t++) {
+    for (long m = 16; m <= 1L << 24; m *= 1024) {
+      std::vector<int> a = sorted_values<int>(sizes[t][0], m, 6),
+                       b = sorted_values<int>(sizes[t][1], m, 7);
+      std::vector<int> res_std(a.size() + b.size()),
+          res_algs(a.size() + b.size(), -1);
+      std::merge(a.begin(), a.end(), b.begin(), b.end(), res_std.begin());
+      assert(algs::merge(algs::par, a.begin(), a.end(), b.begin(), b.end(),
+                         res_algs.begin()) == res_algs.end());
+      assert(res_algs == res_std);
+    }
+  }
+  std::vector<int> even, odd, res_std, res_algs(400000);
+  halves(sorted_values<int>(400000, 1000, 8), even, odd);
+  res_std = even;
+  res_std.insert(res_std.end(), odd.begin(), odd.end());
+  std::sort(res_std.begin(), res_std.end());
+  algs::merge(algs::par, even.begin(), even.end(), odd.begin(), odd.end(),
+              res_algs.begin(), half_less);
+  assert(res_algs == res_std);
+}
+
+void test_inplace_merge() {
+  std::vector<int> v = sorted_values<int>(3000, 700, 11);
+  std::vector<int> even, odd;
+  halves(v, even, odd);
+  long splits[] = {0, 1, 5, 100, 1500, 2900, 2999, 3000};
+  for (int i = 0; i < 8; i++) {
+    long n1 = splits[i];
+    std::vector<int> res_std(v.begin(), v.begin() + n1),
+        rest(v.begin() + n1, v.end());
+    std::sort(rest.begin(), rest.end(), greater);
+    std::sort(res_std.begin(), res_std.end(), greater);
+    res_std.insert(res_std.end(), rest.begin(), rest.end());
+    std::vector<int> res_algs = res_std;
+    std::inplace_merge(res_std.begin(), res_std.begin() + n1, res_std.end(),
+                       greater);
+    algs::inplace_merge(res_algs.begin(), res_algs.begin() + n1,
+                        res_algs.end(), greater);
+    assert(res_algs == res_std);
+    // stability, through the linear merge and the rotations alike
+    std::vector<int> buf(64);
+    for (long len = 0; len <= 64; len += 8) {
+      std::vector<int> both(even.begin(), even.begin() + n1 / 2);
+      both.insert(both.end(), odd.begin(), odd.end());
+      std::vector<int> expect = both;
+      std::sort(expect.begin(), expect.end());
+      algs::inplace_merge(both.begin(), both.begin() + n1 / 2, both.end(),
+                          half_less, &buf[0], len);
+      assert(both == expect);
+    }
+    std::vector<int> expect(even.begin(), even.begin() + n1 / 2);
+    expect.insert(expect.end(), odd.begin(), odd.end());
+    std::list<int> l(expect.begin(), expect.end());
+    std::list<int>::iterator mid = l.begin();
+    std::advance(mid, n1 / 2);
+    algs::inplace_merge(l.begin(), mid, l.end());
+    std::sort(expect.begin(), expect.end());
+    assert(std::equal(l.begin(), l.end(), expect.begin()));
+  }
+}
+
+bool run_less(int x, int y) { return x / 256 < y / 256; }
+
+void test_multiway_merge() {
+  int counts[] = {0, 1, 2, 3, 5, 64, 200};
+  for (int t = 0; t < 7; t++) {
+    int k = counts[t];
+    std::vector<std::vector<int> > runs(k);
+    std::vector<int> all;
+    for (int r = 0; r < k; r++) {
+      // keys repeat across runs; the low byte records the run
+      runs[r] = sorted_values<int>((r * 37) % 11 == 3 ? 0 : 50 + r * 13 % 300,
+                                   500, r);
+      for (std::size_t i = 0; i < runs[r].size(); i++)
+        runs[r][i] = runs[r][i] * 256 + r;
+      all.insert(all.end(), runs[r].begin(), runs[r].end());
+    }
+    std::sort(all.begin(), all.end());
+    std::vector<std::pair<vec_iter, vec_iter> > ranges;
+    for (int r = 0; r < k; r++)
+      ranges.push_back(std::make_pair(runs[r].begin(), runs[r].end()));
+    std::vector<int> res_algs;
+    algs::multiway_merge(ranges.begin(), ranges.end(),
+                         std::back_inserter(res_algs), run_less);
+    assert(res_algs == all);
+    res_algs.assign(all.size(), -1);
+    assert(algs::multiway_merge(ranges.begin(), ranges.end(),
+                                res_algs.begin()) == res_algs.end());
+    assert(res_algs == all);
+  }
+  std::list<int> l1(v3.begin(), v3.end()), l2(v3.begin() + 3, v3.end());
+  std::vector<std::pair<std::list<int>::iterator, std::list<int>::iterator> >
+      lists(1, std::make_pair(l1.begin(), l1.end()));
+  lists.push_back(std::make_pair(l2.begin(), l2.end()));
+  std::vector<int> res_std(17), res_algs(17);
+  std::merge(v3.begin(), v3.end(), v3.begin() + 3, v3.end(), res_std.begin(),
+             greater);
+  algs::multiway_merge(lists.begin(), lists.end(), res_algs.begin(), greater);
+  assert(res_algs == res_std);
+}
+
+void test_kway_merger() {
+  std::istringstream s1("1 4 4 9"), s2(""), s3("0 4 10 11 12");
+  typedef std::istream_iterator<int> stream_iter;
+  std::vector<std::pair<stream_iter, stream_iter> > streams;
+  streams.push_back(std::make_pair(stream_iter(s1), stream_iter()));
+  streams.push_back(std::make_pair(stream_iter(s2), stream_iter()));
+  streams.push_back(std::make_pair(stream_iter(s3), stream_iter()));
+  algs::kway_merger<stream_iter> merger(streams.begin(), streams.end());
+  int expect[] = {0, 1, 4, 4, 4, 9, 10, 11, 12};
+  for (int i = 0; i < 5; i++) {
+    assert(!merger.empty() && merger.top() == expect[i]);
+    merger.pop();
+  }
+  std::vector<int> rest;
+  merger.copy(std::back_inserter(rest));
+  assert(merger.empty());
+  assert(std::equal(rest.begin(), rest.end(), expect + 5) && rest.size() == 4);
+  std::vector<std::pair<vec_iter, vec_iter> > none;
+  algs::kway_merger<vec_iter> empty(none.begin(), none.end());
+  assert(empty.empty());
+  none.push_back(std::make_pair(v1.begin(), v1.begin()));
+  algs::kway_merger<vec_iter> drained(none.begin(), none.end());
+  assert(drained.empty());
+}
+
+void test_eytzinger_index() {
+  algs::eytzinger_index<int> empty(v6.begin(), v6.begin());
+  assert(empty.size() == 0 && empty.lower_bound(3) == 0 && !empty.contains(3));
+  for (int n = 1; n < 100; n++) {
+    std::vector<int> dups;
+    for (int i = 0; i < n; i++)
+      dups.push_back(i / 3 * 2);
+    algs::eytzinger_index<int> index(dups.begin(), dups.end());
+    assert(index.size() == n);
+    for (int x = -1; x <= n; x++) {
+      assert(index.lower_bound(x) ==
+             std::lower_bound(dups.begin(), dups.end(), x) - dups.begin());
+      assert(index.contains(x) ==
+             std::binary_search(dups.begin(), dups.end(), x));
+    }
+  }
+  algs::eytzinger_index<int, bool (*)(int, int)> desc(v3.begin(), v3.end(),
+                                                     greater);
+  assert(desc.lower_bound(4) == 6 && desc.contains(7) && !desc.contains(0));
+}
+
+template <class T> static void check_static_btree(const std::vector<T> &v) {
+  algs::static_btree<T> tree(v.begin(), v.end());
+  algs::static_btree<T> copy;
+  copy = tree;
+  assert(copy.size() == (std::ptrdiff_t)v.size());
+  for (std::size_t i = 0; i <= v.size(); i++) {
+    T x = i < v.size() ? v[i] : v.empty() ? T(0) : T(v.back() + 1);
+    assert(copy.lower_bound(x) ==
+           std::lower_bound(v.begin(), v.end(), x) - v.begin());
+    assert(copy.contains(x) == (i < v.size()));
+    assert(copy.lower_bound(T(x - 1)) ==
+           std::lower_bound(v.begin(), v.end(), T(x - 1)) - v.begin());
+  }
+}
+
+void test_static_btree() {
+  for (int n = 0; n < 300; n++) {
+    std::vector<int> ints;
+    std::vector<unsigned> uints;
+    std::vector<unsigned long> ulongs;
+    std::vector<short> shorts;
+    for (int i = 0; i < n; i++) {
+      ints.push_back(i / 2 * 3 - 100);
+      uints.push_back(i / 2 * 3 + 0x7fffff00u);
+      ulongs.push_back(i * 5 + 0x7fffffffffffff00ul);
+      shorts.push_back(short(i * 2));
+    }
+    check_static_btree(ints);
+    check_static_btree(uints);
+    check_static_btree(ulongs);
+    check_static_btree(shorts);
+  }
+  std::vector<long> longs;
+  for (long i = 0; i < 6000; i++)
+    longs.push_back(i * 7919 % 6000 - 3000);
+  std::sort(longs.begin(), longs.end());
+  check_static_btree(longs);
+  algs::static_btree<long> tree(longs.begin(), longs.end());
+  assert(tree.lower_bound(-4000) == 0 && tree.lower_bound(3000) == 6000);
+}
+
 void test_swap() {
   int x = 69;
   int y = 420;
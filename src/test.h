@@ -27,16 +27,104 @@ void test_remove();
 
 void test_remove_if();
 
+void test_parallel_remove_if();
+
+void test_unstable_remove();
+
+void test_unstable_remove_if();
+
+void test_erase_if();
+
+void test_erase();
+
+void test_replace();
+
+void test_replace_if();
+
+void test_replace_copy();
+
+void test_replace_copy_if();
+
+void test_translate();
+
 void test_partition();
 
+void test_parallel_partition();
+
 void test_reverse();
 
+void test_rotate();
+
+void test_stable_partition();
+
+void test_three_way_partition();
+
+void test_bucket_partition();
+
+void test_sort();
+
+void test_parallel_sort();
+
+void test_stable_sort();
+
+void test_radix_sort();
+
+void test_parallel_radix_sort();
+
+void test_sort_small();
+
+void test_nth_element();
+
+void test_partial_sort();
+
+void test_partial_sort_copy();
+
 void test_accumulate();
 
 void test_for_each();
 
 void test_binary_search();
 
+void test_partition_point();
+
+void test_lower_bound();
+
+void test_upper_bound();
+
+void test_equal_range();
+
+void test_lower_bound_batch();
+
+void test_binary_search_batch();
+
+void test_interpolation_search();
+
+void test_exponential_search();
+
+void test_learned_index();
+
+void test_set_intersection();
+
+void test_set_union();
+
+void test_set_difference();
+
+void test_includes();
+
+void test_merge();
+
+void test_parallel_merge();
+
+void test_inplace_merge();
+
+void test_multiway_merge();
+
+void test_kway_merger();
+
+void test_eytzinger_index();
+
+void test_static_btree();
+
 void test_swap();
 
 void test_max();